@@ -0,0 +1,30 @@
+# Writes `OUTPUT` header with the revision of `SOURCE_DIR` (`git describe --always --dirty`,
+# "unknown" without git). Runs at every build (see CMakeLists.txt), but the header is only
+# rewritten when the revision changes, so unchanged revision doesn't trigger a rebuild.
+
+set(revision "unknown")
+
+if(GIT_EXECUTABLE)
+    execute_process(
+        COMMAND ${GIT_EXECUTABLE} describe --always --dirty
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE output
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE result
+        ERROR_QUIET
+    )
+    if(result EQUAL 0)
+        set(revision ${output})
+    endif()
+endif()
+
+set(content "// Generated at build time by cmake/git_revision.cmake\n#define COPY_RGBA_TO_RGB__GIT_REVISION \"${revision}\"\n")
+
+set(old_content "")
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} old_content)
+endif()
+
+if(NOT content STREQUAL old_content)
+    file(WRITE ${OUTPUT} "${content}")
+endif()
@@ -3,14 +3,79 @@
 
 #include <cstddef> // for: size_t
 #include <cstdint> // for: uint8_t
+#include <cstring> // for: memcpy(), memset(), strerror()
+#include <cerrno>  // for: errno
 
 #include <vector>  // for: std::vector<T>
-#include <cstdlib> // for: rand()
+#include <string>  // for: std::string, std::to_string()
+#include <cstdlib> // for: rand(), strtoull()
 #include <ctime>   // for: seeding rand()
+#include <cmath>   // for: std::sqrt(), std::erfc(), std::floor(), std::fabs()
+
+#include <algorithm>          // for: std::min(), std::max()
+#include <atomic>             // for: std::atomic<T>
+#include <chrono>             // for: std::chrono::steady_clock
+#include <condition_variable> // for: std::condition_variable
+#include <deque>              // for: std::deque<T>
+#include <fstream>            // for: std::ofstream
+#include <functional>         // for: std::function<T>
+#include <memory>             // for: std::unique_ptr<T>
+#include <mutex>              // for: std::mutex, std::unique_lock<T>
+#include <random>             // for: std::mt19937
+#include <sstream>            // for: std::ostringstream
+#include <thread>             // for: std::thread
+
+#include <csetjmp>    // for: sigsetjmp(), siglongjmp()
+#include <csignal>    // for: sigaction()
+#include <pthread.h>  // for: pthread_self()
+#include <unistd.h>   // for: sysconf(), gethostname()
+#include <fcntl.h>    // for: open()
+#include <fnmatch.h>  // for: fnmatch()
+#include <sys/mman.h> // for: mmap(), munmap(), mprotect(), madvise(), msync()
+#include <sys/stat.h> // for: fstat()
+
+#if defined(__linux__)
+    #include <linux/perf_event.h> // for: perf_event_attr
+    #include <sys/ioctl.h>        // for: ioctl()
+    #include <sys/syscall.h>      // for: syscall(), __NR_perf_event_open
+#endif
 
-#if defined(__AVX2__)
+// -----------------------------------------------------------------------------
+// NOTE: SIMD kernels are compiled with per-function `target(...)` attributes,
+// so they exist even in a baseline x86-64 build (without `-march=native`).
+// Which of them is actually called is decided at runtime, see
+// `copy_rgba_to_rgb()` below.
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define COPY_RGBA_TO_RGB__X86 1
+#else
+    #define COPY_RGBA_TO_RGB__X86 0
+#endif
+
+#if COPY_RGBA_TO_RGB__X86
     #include <immintrin.h>
-#endif // defined(__AVX2__)
+    #include <cpuid.h> // for: __get_cpuid(), __get_cpuid_count()
+
+    #define COPY_RGBA_TO_RGB__HAS_SSSE3 1
+    #define COPY_RGBA_TO_RGB__HAS_AVX2  1
+
+    #define COPY_RGBA_TO_RGB__TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define COPY_RGBA_TO_RGB__TARGET_AVX2  __attribute__((target("avx2")))
+
+    #define COPY_RGBA_TO_RGB__TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+
+    #define COPY_RGBA_TO_RGB__TARGET_CLFLUSHOPT __attribute__((target("clflushopt")))
+#else
+    #define COPY_RGBA_TO_RGB__HAS_SSSE3 0
+    #define COPY_RGBA_TO_RGB__HAS_AVX2  0
+
+    #define COPY_RGBA_TO_RGB__TARGET_SSSE3
+    #define COPY_RGBA_TO_RGB__TARGET_AVX2
+
+    #define COPY_RGBA_TO_RGB__TARGET_AVX2_FMA
+
+    #define COPY_RGBA_TO_RGB__TARGET_CLFLUSHOPT
+#endif // COPY_RGBA_TO_RGB__X86
 
 // -----------------------------------------------------------------------------
 // NOTE: before benchmarking make sure, that CPU 'min_freq' and 'max_freq' is
@@ -56,6 +121,367 @@ void print_lscpu()
 
 // -----------------------------------------------------------------------------
 
+struct cpu_features_t
+{
+    bool ssse3      = false;
+    bool avx2       = false;
+    bool fma        = false; // For float kernels (with AVX2)
+    bool clflushopt = false; // Not SIMD, for cold cache benchmarks
+};
+
+/*
+    Probes CPU (via CPUID) and OS (via XGETBV) support of instruction sets,
+    used by kernels below.
+
+    NOTE: CPUID reporting AVX2 is not enough: OS also must save/restore the
+    upper halves of YMM registers on context switch, otherwise using them leads
+    to data corruption. That's reported by OSXSAVE bit and XCR0 register.
+*/
+cpu_features_t detect_cpu_features()
+{
+    cpu_features_t features;
+
+    #if COPY_RGBA_TO_RGB__X86
+    {
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if( __get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 )
+        {
+            return features; // CPUID leaf 1 not supported
+        }
+
+        features.ssse3 = (ecx & bit_SSSE3) != 0;
+
+        const bool has_osxsave = (ecx & bit_OSXSAVE) != 0;
+        const bool has_avx     = (ecx & bit_AVX    ) != 0;
+        const bool has_fma     = (ecx & bit_FMA    ) != 0;
+
+        unsigned int eax7 = 0, ebx7 = 0, ecx7 = 0, edx7 = 0;
+        const bool has_leaf7 = __get_cpuid_count(7, 0, &eax7, &ebx7, &ecx7, &edx7) != 0;
+
+        if(has_osxsave && has_avx)
+        {
+            uint32_t xcr0_lo = 0, xcr0_hi = 0;
+            __asm__ __volatile__ ("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+
+            const bool os_saves_xmm_ymm = (xcr0_lo & 0x6) == 0x6; // bit 1 - XMM state, bit 2 - YMM state
+            if(os_saves_xmm_ymm && has_leaf7)
+            {
+                features.avx2 = (ebx7 & bit_AVX2) != 0;
+            }
+            features.fma = os_saves_xmm_ymm && has_fma;
+        }
+
+        features.clflushopt = has_leaf7 && ((ebx7 & bit_CLFLUSHOPT) != 0);
+    }
+    #endif // COPY_RGBA_TO_RGB__X86
+
+    return features;
+}
+
+// Detected once, on first call
+const cpu_features_t& get_cpu_features()
+{
+    static const cpu_features_t features = detect_cpu_features();
+    return features;
+}
+
+// Data cache sizes, in bytes (0 - if there is no such level, or it's unknown)
+struct cache_sizes_t
+{
+    size_t l1d = 0;
+    size_t l2  = 0;
+    size_t l3  = 0;
+};
+
+cache_sizes_t detect_cache_sizes()
+{
+    cache_sizes_t sizes;
+
+    #if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+    {
+        const long l1d = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+        const long l2  = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        const long l3  = sysconf(_SC_LEVEL3_CACHE_SIZE);
+
+        if(l1d > 0) { sizes.l1d = static_cast<size_t>(l1d); }
+        if(l2  > 0) { sizes.l2  = static_cast<size_t>(l2);  }
+        if(l3  > 0) { sizes.l3  = static_cast<size_t>(l3);  }
+    }
+    #endif
+
+    return sizes;
+}
+
+// Size of the last-level (L3, or L2 if there is no L3) data cache, in bytes
+size_t detect_last_level_cache_size()
+{
+    static constexpr size_t FALLBACK_SIZE = 4 * 1024 * 1024; // 4 MiB
+
+    const cache_sizes_t sizes = detect_cache_sizes();
+    if(sizes.l3 > 0) { return sizes.l3; }
+    if(sizes.l2 > 0) { return sizes.l2; }
+
+    return FALLBACK_SIZE;
+}
+
+// Human-readable size: "512 B", "48 KiB", "1.25 MiB", ...
+std::string format_bytes(size_t bytes)
+{
+    char buf[32];
+    if(bytes < 1024)
+    {
+        snprintf(buf, sizeof(buf), "%zu B", bytes);
+    }
+    else if(bytes < (1024 * 1024))
+    {
+        snprintf(buf, sizeof(buf), "%.4g KiB", static_cast<double>(bytes) / 1024.0);
+    }
+    else
+    {
+        snprintf(buf, sizeof(buf), "%.4g MiB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+    }
+    return std::string(buf);
+}
+
+// Current resident set size of the process, in bytes (or 0, if unknown)
+size_t current_rss_bytes()
+{
+    size_t rss_bytes = 0;
+
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if(fp != nullptr)
+    {
+        unsigned long size_pages = 0, resident_pages = 0;
+        if( fscanf(fp, "%lu %lu", &size_pages, &resident_pages) == 2 )
+        {
+            rss_bytes = static_cast<size_t>(resident_pages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        }
+        fclose(fp);
+    }
+
+    return rss_bytes;
+}
+
+// Pages, backing `mapped_buffer_t`
+enum class page_kind_t
+{
+    regular,          // 4 KiB
+    huge_tlbfs,       // 2 MiB, reserved (`MAP_HUGETLB`, needs `vm.nr_hugepages`)
+    transparent_huge, // 2 MiB, if kernel finds them (`madvise(MADV_HUGEPAGE)`)
+};
+
+const char* to_string(page_kind_t pages)
+{
+    switch(pages)
+    {
+        case page_kind_t::regular:          return "4 KiB";
+        case page_kind_t::huge_tlbfs:       return "2 MiB (hugetlbfs)";
+        case page_kind_t::transparent_huge: return "2 MiB (transparent)";
+    }
+    return "unknown";
+}
+
+/*
+    Anonymous memory mapping. Unlike heap memory (which allocator may keep for
+    reuse), it's returned to OS on destruction, so RSS measurements are exact.
+
+    With `huge_pages` mapping is 2 MiB aligned and backed by 2 MiB pages: one
+    TLB entry covers 512x more memory (1080p RGBA + RGB: 7 pages instead of
+    ~3500). Reserved huge pages are tried first, then transparent ones; see
+    `pages()` for what was actually used.
+*/
+class mapped_buffer_t
+{
+public:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    explicit mapped_buffer_t(size_t size, bool huge_pages = false)
+        : m_size(size)
+    {
+        if(huge_pages == false)
+        {
+            m_mapping_size = m_size;
+            void* ptr = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            m_data = (ptr == MAP_FAILED) ? nullptr : static_cast<uint8_t*>(ptr);
+            return;
+        }
+
+        m_mapping_size = ((m_size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+
+        #if defined(MAP_HUGETLB)
+        {
+            void* ptr = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if(ptr != MAP_FAILED)
+            {
+                m_data  = static_cast<uint8_t*>(ptr);
+                m_pages = page_kind_t::huge_tlbfs;
+                return;
+            }
+        }
+        #endif
+
+        // Over-allocate by one huge page, and unmap the unaligned head and the tail
+        void* ptr = mmap(nullptr, m_mapping_size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(ptr == MAP_FAILED)
+        {
+            return;
+        }
+
+        uint8_t* const mapping = static_cast<uint8_t*>(ptr);
+        uint8_t* const aligned = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(mapping) + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+        const size_t   head    = static_cast<size_t>(aligned - mapping);
+        const size_t   tail    = HUGE_PAGE_SIZE - head;
+
+        if(head > 0) { munmap(mapping, head); }
+        if(tail > 0) { munmap(aligned + m_mapping_size, tail); }
+
+        m_data = aligned;
+
+        #if defined(MADV_HUGEPAGE)
+        if(madvise(m_data, m_mapping_size, MADV_HUGEPAGE) == 0)
+        {
+            m_pages = page_kind_t::transparent_huge;
+        }
+        #endif
+    }
+
+    ~mapped_buffer_t()
+    {
+        if(m_data != nullptr)
+        {
+            munmap(m_data, m_mapping_size);
+        }
+    }
+
+    mapped_buffer_t(const mapped_buffer_t&) = delete;
+    mapped_buffer_t& operator=(const mapped_buffer_t&) = delete;
+
+    uint8_t*    data()         const { return m_data; }
+    size_t      size()         const { return m_size; }
+    size_t      mapping_size() const { return m_mapping_size; } // `size()`, rounded up to pages
+    page_kind_t pages()        const { return m_pages; }
+
+private:
+    uint8_t*    m_data         = nullptr;
+    size_t      m_size         = 0;
+    size_t      m_mapping_size = 0;
+    page_kind_t m_pages        = page_kind_t::regular;
+};
+
+/*
+    Bytes of mapping, which starts at `ptr`, actually backed by transparent
+    huge pages (`AnonHugePages` of `/proc/self/smaps`): `madvise()` is only a
+    hint, kernel may fail to find free 2 MiB blocks.
+*/
+size_t transparent_huge_page_bytes(const void* ptr)
+{
+    size_t bytes = 0;
+
+    FILE* fp = fopen("/proc/self/smaps", "r");
+    if(fp != nullptr)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(ptr);
+
+        bool in_mapping = false;
+        char line[512];
+        while(fgets(line, sizeof(line), fp) != nullptr)
+        {
+            unsigned long begin = 0, end = 0;
+            if(sscanf(line, "%lx-%lx ", &begin, &end) == 2)
+            {
+                in_mapping = (begin <= address) && (address < end);
+            }
+            else if(in_mapping && sscanf(line, "AnonHugePages: %lu kB", &begin) == 1)
+            {
+                bytes = static_cast<size_t>(begin) * 1024;
+                break;
+            }
+        }
+        fclose(fp);
+    }
+
+    return bytes;
+}
+
+/*
+    Counter of data TLB misses (loads and stores) of the calling thread, via
+    `perf_event_open()`. nanobench counts only cycles, instructions and
+    branches, so TLB is counted separately. Not valid, if kernel or
+    container doesn't allow it (see `/proc/sys/kernel/perf_event_paranoid`).
+*/
+class dtlb_miss_counter_t
+{
+public:
+    dtlb_miss_counter_t()
+    {
+        #if defined(__linux__)
+        m_load_fd  = open_counter(PERF_COUNT_HW_CACHE_OP_READ);
+        m_store_fd = open_counter(PERF_COUNT_HW_CACHE_OP_WRITE); // Not supported by some CPUs: then loads only
+        #endif
+    }
+
+    ~dtlb_miss_counter_t()
+    {
+        if(m_load_fd  >= 0) { close(m_load_fd);  }
+        if(m_store_fd >= 0) { close(m_store_fd); }
+    }
+
+    dtlb_miss_counter_t(const dtlb_miss_counter_t&) = delete;
+    dtlb_miss_counter_t& operator=(const dtlb_miss_counter_t&) = delete;
+
+    bool valid() const { return m_load_fd >= 0; }
+
+    // Misses during `func()`
+    template<typename Func>
+    uint64_t count(const Func& func) const
+    {
+        #if defined(__linux__)
+        for(const int fd : {m_load_fd, m_store_fd})
+        {
+            if(fd >= 0) { ioctl(fd, PERF_EVENT_IOC_RESET, 0); ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); }
+        }
+        #endif
+
+        func();
+
+        uint64_t misses = 0;
+        #if defined(__linux__)
+        for(const int fd : {m_load_fd, m_store_fd})
+        {
+            uint64_t value = 0;
+            if(fd >= 0 && ioctl(fd, PERF_EVENT_IOC_DISABLE, 0) == 0 && read(fd, &value, sizeof(value)) == sizeof(value))
+            {
+                misses += value;
+            }
+        }
+        #endif
+
+        return misses;
+    }
+
+private:
+    #if defined(__linux__)
+    static int open_counter(uint64_t op)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type           = PERF_TYPE_HW_CACHE;
+        attr.size           = sizeof(attr);
+        attr.config         = PERF_COUNT_HW_CACHE_DTLB | (op << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0)); // This thread, any CPU
+    }
+    #endif
+
+    int m_load_fd  = -1;
+    int m_store_fd = -1;
+};
+
+// -----------------------------------------------------------------------------
+
 std::vector<uint8_t> make_ascending_data(size_t size)
 {
     std::vector<uint8_t> data(size);
@@ -126,6 +552,94 @@ bool compare_rgba_to_rgb(const uint8_t* rgba, const uint8_t* rgb, size_t num_pix
     return true;
 }
 
+// Compares an RGB buffer to an RGBA buffer (expecting constant alpha channel)
+bool compare_rgb_to_rgba(const uint8_t* rgb, const uint8_t* rgba, size_t num_pixels, uint8_t alpha)
+{
+    for(size_t i = 0; i < num_pixels; ++i)
+    {
+        const uint8_t* src = rgb  + (i * 3);
+        const uint8_t* dst = rgba + (i * 4);
+
+        if( (src[0] != dst[0]) || (src[1] != dst[1]) || (src[2] != dst[2]) || (dst[3] != alpha) )
+        {
+            fprintf(
+                stdout,
+                "Mismatch at i=%zu: RGB(%d, %d, %d) but got RGBA(%d, %d, %d, %d), expected alpha: %d\n",
+                i, src[0], src[1], src[2], dst[0], dst[1], dst[2], dst[3], alpha
+            );
+            fflush(stdout);
+
+            return false; // Stop as soon as we detect an error
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Channel orders: byte offset of each channel within a pixel
+
+struct rgba_order_t { static constexpr int R = 0, G = 1, B = 2, A = 3; };
+struct bgra_order_t { static constexpr int B = 0, G = 1, R = 2, A = 3; }; // Windows/DirectX capture
+struct argb_order_t { static constexpr int A = 0, R = 1, G = 2, B = 3; };
+struct abgr_order_t { static constexpr int A = 0, B = 1, G = 2, R = 3; };
+
+struct rgb_order_t  { static constexpr int R = 0, G = 1, B = 2; };
+struct bgr_order_t  { static constexpr int B = 0, G = 1, R = 2; };
+
+/*
+    Permutation of 4 pixels (16 bytes) of `SrcOrder` into 4 pixels (12 bytes)
+    of `DstOrder`: for each destination byte - index of the source byte, or
+    `-1` (skipped byte). Used to build `_mm256_shuffle_epi8()` masks at
+    compile time.
+*/
+template<typename SrcOrder, typename DstOrder>
+struct shuffle_4ch_to_3ch_t
+{
+    // Offset in source pixel of the channel, which is at `dst_offset` in destination pixel
+    static constexpr int src_offset(int dst_offset)
+    {
+        return (dst_offset == DstOrder::R) ? SrcOrder::R :
+               (dst_offset == DstOrder::G) ? SrcOrder::G :
+                                             SrcOrder::B;
+    }
+
+    static constexpr int index(int dst_byte)
+    {
+        return (dst_byte >= 12) ? -1 : ( ((dst_byte / 3) * 4) + src_offset(dst_byte % 3) );
+    }
+};
+
+// Sanity check: RGBA --> RGB is the original `2,1,0, 6,5,4, ...` mask
+static_assert(shuffle_4ch_to_3ch_t<rgba_order_t, rgb_order_t>::index( 0) ==  0, "");
+static_assert(shuffle_4ch_to_3ch_t<rgba_order_t, rgb_order_t>::index( 5) ==  6, "");
+static_assert(shuffle_4ch_to_3ch_t<rgba_order_t, rgb_order_t>::index(11) == 14, "");
+static_assert(shuffle_4ch_to_3ch_t<rgba_order_t, rgb_order_t>::index(12) == -1, "");
+static_assert(shuffle_4ch_to_3ch_t<bgra_order_t, rgb_order_t>::index( 0) ==  2, "");
+
+// Compares 4-channel buffer to 3-channel buffer (ignoring alpha channel)
+template<typename SrcOrder, typename DstOrder>
+bool compare_4ch_to_3ch(const uint8_t* src, const uint8_t* dst, size_t num_pixels)
+{
+    for(size_t i = 0; i < num_pixels; ++i)
+    {
+        const uint8_t* s = src + (i * 4);
+        const uint8_t* d = dst + (i * 3);
+
+        if( (s[SrcOrder::R] != d[DstOrder::R]) || (s[SrcOrder::G] != d[DstOrder::G]) || (s[SrcOrder::B] != d[DstOrder::B]) )
+        {
+            fprintf(
+                stdout,
+                "Mismatch at i=%zu: source(R=%d, G=%d, B=%d) but got destination(R=%d, G=%d, B=%d)\n",
+                i, s[SrcOrder::R], s[SrcOrder::G], s[SrcOrder::B], d[DstOrder::R], d[DstOrder::G], d[DstOrder::B]
+            );
+            fflush(stdout);
+
+            return false; // Stop as soon as we detect an error
+        }
+    }
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 
 void copy_rgba_to_rgb__memcpy(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
@@ -217,67 +731,398 @@ void copy_rgba_to_rgb__raw_ptr__4pixels(const uint8_t* rgba, uint8_t* rgb, size_
     }
 }
 
-// -----------------------------------------------------------------------------
-
-#if defined(__AVX2__)
+// Same as `copy_rgba_to_rgb__raw_ptr()`, but for any channel orders
+template<typename SrcOrder, typename DstOrder>
+void copy_4ch_to_3ch__raw_ptr(const uint8_t* src, uint8_t* dst, size_t num_pixels)
+{
+    size_t i = 0;
+    for(; i < num_pixels; ++i)
+    {
+        dst[DstOrder::R] = src[SrcOrder::R]; // Copy R
+        dst[DstOrder::G] = src[SrcOrder::G]; // Copy G
+        dst[DstOrder::B] = src[SrcOrder::B]; // Copy B
+        src += 4;
+        dst += 3;
+    }
+}
 
-    #if !defined(COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH)
-        #define COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH 0
-    #endif
+/*
+    SWAR (SIMD Within A Register): portable, for CPUs without SSSE3.
 
-void copy_rgba_to_rgb__avx2__8pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
-{
-    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
-    //
-    // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
-    // Each pixel is stored as [R,G,B,A], but we want only [R,G,B]
-    const __m256i shuffle_mask = _mm256_set_epi8(
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0, // Extract 4 RGB from second half
+    Two RGBA pixels are loaded as a single `uint64_t` (little-endian):
 
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0  // Extract 4 RGB from first half
-    );
+        bytes: |R0 G0 B0 A0|R1 G1 B1 A1|
 
-    // Reusable
-    __m256i v;
-    __m128i part_128;
+    and alpha is removed by shift/mask, packing 4 pixels (two words) into
+    12 bytes: one 8-byte and one 4-byte store.
+*/
+void copy_rgba_to_rgb__swar__4pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
     size_t i = 0;
 
-    const size_t num_8pixel_blocks = num_pixels / 8; //  Process 8 pixels per iteration
-    if(num_8pixel_blocks > 0)
+    #if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
     {
-        /*
-            Run the main loop for all but the last block
+        const size_t num_4pixel_blocks = num_pixels / 4; // Process 4 pixels per iteration
 
-            Its important, since `_mm_storeu_si128()` calls stores memory by
-            16 bytes (128 bits / 8 = 16 bytes). So, even we store memory in
-            overlapped manner:
+        uint64_t w0, w1;
+        for(; i < num_4pixel_blocks; ++i)
+        {
+            memcpy(&w0, rgba,     sizeof(w0)); // Pixels 0, 1
+            memcpy(&w1, rgba + 8, sizeof(w1)); // Pixels 2, 3
 
-                                  |00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15|16 17 18 19 20 21 22 23 24 25 26 27|28 29 30 ..
-            _mm_storeu_si128() -> |RR GG BB|RR GG BB|RR GG BB|RR GG BB|xx xx xx xx|                                   |
-                                  +-----------------------------------------------+                                   |
-                                               _mm_storeu_si128() --> |RR GG BB|RR GG BB|RR GG BB|RR GG BB|xx xx xx xx|
-                                                                      +-----------------------------------------------+
+            // |R0 G0 B0 R1 G1 B1 00 00|
+            const uint64_t p01 = (w0 & 0x0000000000FFFFFFull) | ((w0 >> 8) & 0x0000FFFFFF000000ull);
+            const uint64_t p23 = (w1 & 0x0000000000FFFFFFull) | ((w1 >> 8) & 0x0000FFFFFF000000ull);
 
-            them writes total 28 bytes into `rgb` buffer on each iteration.
+            const uint64_t out0 = p01 | (p23 << 48);                  // |R0 G0 B0 R1 G1 B1 R2 G2|
+            const uint32_t out1 = static_cast<uint32_t>(p23 >> 16);   // |B2 R3 G3 B3|
 
-            It may cause write out-of-bound, if rgb buffer too small, for
-            example - if rgb buffer store exactly 8 pixels --> 8 * 3 = 24 bytes,
-            but we write 28 bytes into it.
+            memcpy(rgb,     &out0, sizeof(out0));
+            memcpy(rgb + 8, &out1, sizeof(out1));
 
-            That's why we write 'not-precise' but 'faster' (due to storage by
-            larger chunks of memory) only if we have anough space for it.
-        */
-        for(; i < (num_8pixel_blocks - 1); ++i)
-        {
-            #if COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH == 1
-            {
-                // (Optional) Prefetching: Load data into (L1) cache before it's needed (improves performance)
-                _mm_prefetch((const char*)(rgba + 32), _MM_HINT_T0); // 32 bytes <-- 8 RGBA pixels * 4 bytes each
-                _mm_prefetch((const char*)(rgb  + 28), _MM_HINT_T0); // 28 bytes of rgb buffer, to write into
-            }
-            #endif
+            rgba += 16; // Move forward by 4 pixels in RGBA (4 * 4 = 16)
+            rgb  += 12; // Move forward by 4 pixels in RGB  (4 * 3 = 12)
+        }
+
+        i = num_4pixel_blocks * 4; // Number of processed pixels
+    }
+    #endif // little-endian
+
+    // Handle the remaining pixels (fallback to scalar loop)
+    for(; i < num_pixels; ++i)
+    {
+        rgb[0] = rgba[0]; // Copy R
+        rgb[1] = rgba[1]; // Copy G
+        rgb[2] = rgba[2]; // Copy B
+        rgba += 4;
+        rgb  += 3;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+#if COPY_RGBA_TO_RGB__HAS_SSSE3
+
+// Same as `make_shuffle_mask_4ch_to_3ch__avx2()`, but for 128-bit registers
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_SSSE3
+static inline __m128i make_shuffle_mask_4ch_to_3ch__ssse3()
+{
+    using P = shuffle_4ch_to_3ch_t<SrcOrder, DstOrder>;
+    return _mm_setr_epi8(
+        P::index( 0), P::index( 1), P::index( 2), P::index( 3), P::index( 4), P::index( 5), P::index( 6), P::index( 7),
+        P::index( 8), P::index( 9), P::index(10), P::index(11), P::index(12), P::index(13), P::index(14), P::index(15)
+    );
+}
+
+/*
+    SSSE3 version of `copy_4ch_to_3ch__avx2__*()` kernels, for CPUs without
+    AVX2 (Atom, Celeron, ...): `_mm_shuffle_epi8()` converts 4 pixels per
+    128-bit register, `BLOCK_PIXELS / 4` registers per iteration.
+
+    Store layout is the same: each 16-byte store has 12 useful bytes, so all
+    but the last block are stored in overlapped manner, and only the last
+    4 pixels of the last block are stored precisely (8 + 4 bytes).
+*/
+template<typename SrcOrder, typename DstOrder, size_t BLOCK_PIXELS>
+COPY_RGBA_TO_RGB__TARGET_SSSE3
+void copy_4ch_to_3ch__ssse3(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    static_assert((BLOCK_PIXELS % 4) == 0, "Block must be multiple of 4 pixels");
+    static constexpr size_t NUM_VECTORS = BLOCK_PIXELS / 4;
+
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    const __m128i shuffle_mask = make_shuffle_mask_4ch_to_3ch__ssse3<SrcOrder, DstOrder>();
+
+    // Reusable
+    __m128i v[NUM_VECTORS];
+    size_t i = 0;
+
+    const size_t num_blocks = num_pixels / BLOCK_PIXELS;
+    if(num_blocks > 0)
+    {
+        // Run the main loop for all but the last block (overlapping stores)
+        for(; i < (num_blocks - 1); ++i)
+        {
+            for(size_t k = 0; k < NUM_VECTORS; ++k)
+            {
+                v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + (k * 16)));
+            }
+
+            for(size_t k = 0; k < NUM_VECTORS; ++k)
+            {
+                v[k] = _mm_shuffle_epi8(v[k], shuffle_mask);
+            }
+
+            for(size_t k = 0; k < NUM_VECTORS; ++k)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + (k * 12)), v[k]); // Store 16 bytes (useful - first 12 bytes, 4 RGB pixels)
+            }
+
+            rgba += BLOCK_PIXELS * 4;
+            rgb  += BLOCK_PIXELS * 3;
+        }
+
+        // Last block - precise
+        {
+            for(size_t k = 0; k < NUM_VECTORS; ++k)
+            {
+                v[k] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + (k * 16))), shuffle_mask);
+            }
+
+            for(size_t k = 0; k < (NUM_VECTORS - 1); ++k)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + (k * 12)), v[k]); // Store 16 bytes (useful - first 12 bytes, 4 RGB pixels)
+            }
+
+            uint8_t* last = rgb + ((NUM_VECTORS - 1) * 12);
+            _mm_storeu_si64(last,     v[NUM_VECTORS - 1]);                     // Store 8 bytes
+            _mm_storeu_si32(last + 8, _mm_srli_si128(v[NUM_VECTORS - 1], 8)); // Store 4 bytes
+
+            rgba += BLOCK_PIXELS * 4;
+            rgb  += BLOCK_PIXELS * 3;
+        }
+    }
+
+    // Handle the remaining pixels (fallback to scalar loop)
+    i = num_blocks * BLOCK_PIXELS; // Number of processed pixels
+    for(; i < num_pixels; ++i)
+    {
+        rgb[DstOrder::R] = rgba[SrcOrder::R]; // Copy R
+        rgb[DstOrder::G] = rgba[SrcOrder::G]; // Copy G
+        rgb[DstOrder::B] = rgba[SrcOrder::B]; // Copy B
+        rgba += 4;
+        rgb  += 3;
+    }
+}
+
+COPY_RGBA_TO_RGB__TARGET_SSSE3
+void copy_rgba_to_rgb__ssse3__8pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__ssse3<rgba_order_t, rgb_order_t, 8>(rgba, rgb, num_pixels);
+}
+
+COPY_RGBA_TO_RGB__TARGET_SSSE3
+void copy_rgba_to_rgb__ssse3__16pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__ssse3<rgba_order_t, rgb_order_t, 16>(rgba, rgb, num_pixels);
+}
+
+COPY_RGBA_TO_RGB__TARGET_SSSE3
+void copy_rgba_to_rgb__ssse3__32pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__ssse3<rgba_order_t, rgb_order_t, 32>(rgba, rgb, num_pixels);
+}
+
+COPY_RGBA_TO_RGB__TARGET_SSSE3
+void copy_rgba_to_rgb__ssse3__64pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__ssse3<rgba_order_t, rgb_order_t, 64>(rgba, rgb, num_pixels);
+}
+
+#endif // COPY_RGBA_TO_RGB__HAS_SSSE3
+
+// -----------------------------------------------------------------------------
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+
+    #if !defined(COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH)
+        #define COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH 0
+    #endif
+
+/*
+    Builds shuffle mask from `shuffle_4ch_to_3ch_t` permutation: all arguments
+    are constant expressions, so it's folded into a single constant vector.
+
+    NOTE: in all `copy_4ch_to_3ch__avx2__*()` kernels `rgba` and `rgb` stand
+    for any 4-channel (`SrcOrder`) and 3-channel (`DstOrder`) buffers.
+*/
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline __m256i make_shuffle_mask_4ch_to_3ch__avx2()
+{
+    using P = shuffle_4ch_to_3ch_t<SrcOrder, DstOrder>;
+    return _mm256_setr_epi8(
+        // First half (4 pixels)
+        P::index( 0), P::index( 1), P::index( 2), P::index( 3), P::index( 4), P::index( 5), P::index( 6), P::index( 7),
+        P::index( 8), P::index( 9), P::index(10), P::index(11), P::index(12), P::index(13), P::index(14), P::index(15),
+
+        // Second half (4 pixels)
+        P::index( 0), P::index( 1), P::index( 2), P::index( 3), P::index( 4), P::index( 5), P::index( 6), P::index( 7),
+        P::index( 8), P::index( 9), P::index(10), P::index(11), P::index(12), P::index(13), P::index(14), P::index(15)
+    );
+}
+
+/*
+    Stores 8 shuffled pixels (12 useful bytes in each half of `v`) as 28 bytes
+    (the last 4 - junk, see `copy_rgba_to_rgb__avx2__8pixels()`). Caller must
+    guarantee that these 4 bytes are either overwritten later, or are allowed
+    to be clobbered.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void store_8rgb_pixels__avx2__overlapping(uint8_t* rgb, const __m256i& v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb     ), _mm256_extracti128_si256(v, 0)); // 16 bytes (useful - first 12)
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + 12), _mm256_extracti128_si256(v, 1)); // 16 bytes (useful - first 12)
+}
+
+// Stores 8 shuffled pixels as exactly 24 bytes
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void store_8rgb_pixels__avx2__precise(uint8_t* rgb, const __m256i& v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb), _mm256_extracti128_si256(v, 0)); // 16 bytes (useful - first 12)
+
+    __m128i part_128 = _mm256_extracti128_si256(v, 1);
+    _mm_storeu_si64(rgb + 12, part_128); // 8 bytes
+    part_128 = _mm_srli_si128(part_128, 8);
+    _mm_storeu_si32(rgb + 20, part_128); // 4 bytes
+}
+
+// Converts 8 pixels, storing 28 bytes (the last 4 - junk, see `store_8rgb_pixels__avx2__overlapping()`)
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void copy_rgba_to_rgb__avx2__block8__overlapping(const uint8_t* rgba, uint8_t* rgb, const __m256i& shuffle_mask)
+{
+    store_8rgb_pixels__avx2__overlapping(rgb, _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba)), shuffle_mask));
+}
+
+// Converts 8 pixels, storing exactly 24 bytes
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void copy_rgba_to_rgb__avx2__block8__precise(const uint8_t* rgba, uint8_t* rgb, const __m256i& shuffle_mask)
+{
+    store_8rgb_pixels__avx2__precise(rgb, _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba)), shuffle_mask));
+}
+
+/*
+    Converts 1..7 pixels, storing exactly `num_pixels * 3` bytes.
+
+    `_mm256_maskload_epi32()` reads only `num_pixels` dwords (pixels), masked
+    out ones are not accessed at all (so can't fault, even past the end of
+    the page). After shuffle useful bytes are made contiguous (dwords 0..5),
+    whole dwords are stored by `_mm256_maskstore_epi32()` and the remaining
+    1..3 bytes - one by one.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void copy_rgba_to_rgb__avx2__block8__masked(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels, const __m256i& shuffle_mask)
+{
+    const __m256i dword_index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    const __m256i load_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(num_pixels)), dword_index);
+    __m256i v = _mm256_maskload_epi32(reinterpret_cast<const int*>(rgba), load_mask);
+
+    v = _mm256_shuffle_epi8(v, shuffle_mask);
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0,1,2,4,5,6, 3,7)); // dwords 6,7 - junk
+
+    const size_t num_bytes  = num_pixels * 3;
+    const size_t num_dwords = num_bytes / 4;
+
+    const __m256i store_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(num_dwords)), dword_index);
+    _mm256_maskstore_epi32(reinterpret_cast<int*>(rgb), store_mask, v);
+
+    // Last (incomplete) dword: 0..3 bytes
+    uint32_t last_dword = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(
+        _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(static_cast<int>(num_dwords))))));
+    for(size_t b = num_dwords * 4; b < num_bytes; ++b)
+    {
+        rgb[b] = static_cast<uint8_t>(last_dword);
+        last_dword >>= 8;
+    }
+}
+
+/*
+    Converts the remainder of the kernel's main loop - `num_pixels` pixels,
+    which is less than the kernel's block size - without per-pixel scalar loop:
+
+      - Whole 8-pixel blocks are converted one by one (overlapping store, if
+        junk bytes will be overwritten by the next pixels, precise otherwise).
+      - Remaining 1..7 pixels: if at least `8 - remainder` already converted
+        pixels precede `rgba`/`rgb` (`num_preceding_pixels`), one more
+        precise 8-pixel block, aligned to the end, re-converts them. Otherwise
+        (the whole buffer is smaller than 8 pixels) - masked load/store.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void copy_rgba_to_rgb__avx2__tail(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels, size_t num_preceding_pixels, const __m256i& shuffle_mask)
+{
+    for(; num_pixels >= 8; num_pixels -= 8, num_preceding_pixels += 8)
+    {
+        // 4 junk bytes fit into the next (at least 2) pixels
+        if(num_pixels >= 10)
+        {
+            copy_rgba_to_rgb__avx2__block8__overlapping(rgba, rgb, shuffle_mask);
+        }
+        else
+        {
+            copy_rgba_to_rgb__avx2__block8__precise(rgba, rgb, shuffle_mask);
+        }
+        rgba += 32; // Move forward by 8 pixels in RGBA (8 * 4 = 32)
+        rgb  += 24; // Move forward by 8 pixels in RGB  (8 * 3 = 24)
+    }
+
+    if(num_pixels == 0)
+    {
+        return;
+    }
+
+    const size_t num_overlapped_pixels = 8 - num_pixels;
+    if(num_preceding_pixels >= num_overlapped_pixels)
+    {
+        copy_rgba_to_rgb__avx2__block8__precise(rgba - (num_overlapped_pixels * 4), rgb - (num_overlapped_pixels * 3), shuffle_mask);
+    }
+    else
+    {
+        copy_rgba_to_rgb__avx2__block8__masked(rgba, rgb, num_pixels, shuffle_mask);
+    }
+}
+
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__8pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    //
+    // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
+
+    // Reusable
+    __m256i v;
+    __m128i part_128;
+    size_t i = 0;
+
+    const size_t num_8pixel_blocks = num_pixels / 8; //  Process 8 pixels per iteration
+    if(num_8pixel_blocks > 0)
+    {
+        /*
+            Run the main loop for all but the last block
+
+            Its important, since `_mm_storeu_si128()` calls stores memory by
+            16 bytes (128 bits / 8 = 16 bytes). So, even we store memory in
+            overlapped manner:
+
+                                  |00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15|16 17 18 19 20 21 22 23 24 25 26 27|28 29 30 ..
+            _mm_storeu_si128() -> |RR GG BB|RR GG BB|RR GG BB|RR GG BB|xx xx xx xx|                                   |
+                                  +-----------------------------------------------+                                   |
+                                               _mm_storeu_si128() --> |RR GG BB|RR GG BB|RR GG BB|RR GG BB|xx xx xx xx|
+                                                                      +-----------------------------------------------+
+
+            them writes total 28 bytes into `rgb` buffer on each iteration.
+
+            It may cause write out-of-bound, if rgb buffer too small, for
+            example - if rgb buffer store exactly 8 pixels --> 8 * 3 = 24 bytes,
+            but we write 28 bytes into it.
+
+            That's why we write 'not-precise' but 'faster' (due to storage by
+            larger chunks of memory) only if we have anough space for it.
+        */
+        for(; i < (num_8pixel_blocks - 1); ++i)
+        {
+            #if COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH == 1
+            {
+                // (Optional) Prefetching: Load data into (L1) cache before it's needed (improves performance)
+                _mm_prefetch((const char*)(rgba + 32), _MM_HINT_T0); // 32 bytes <-- 8 RGBA pixels * 4 bytes each
+                _mm_prefetch((const char*)(rgb  + 28), _MM_HINT_T0); // 28 bytes of rgb buffer, to write into
+            }
+            #endif
 
             // -----------------------------------------------------------------
 
@@ -363,31 +1208,27 @@ void copy_rgba_to_rgb__avx2__8pixels(const uint8_t* rgba, uint8_t* rgb, size_t n
         }
     }
 
-    // Handle the remaining pixels (fallback to scalar loop)
+    // Handle the remaining pixels (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
     i = num_8pixel_blocks * 8; // Number of processed pixels
-    for(; i < num_pixels; ++i)
-    {
-        rgb[0] = rgba[0]; // Copy R
-        rgb[1] = rgba[1]; // Copy G
-        rgb[2] = rgba[2]; // Copy B
-        rgba += 4;
-        rgb  += 3;
-    }
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
 }
 
-void copy_rgba_to_rgb__avx2__16pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__8pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__avx2__8pixels<rgba_order_t, rgb_order_t>(rgba, rgb, num_pixels);
+}
+
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__16pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
 {
     // Shuffle mask to extract RGB bytes while discarding the Alpha byte
     //
     // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
-    // Each pixel is stored as [R,G,B,A], but we want only [R,G,B]
-    const __m256i shuffle_mask = _mm256_set_epi8(
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0, // Extract 4 RGB from second half
-
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0  // Extract 4 RGB from first half
-    );
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
 
     // Reusable
     __m256i v[2];
@@ -545,31 +1386,27 @@ void copy_rgba_to_rgb__avx2__16pixels(const uint8_t* rgba, uint8_t* rgb, size_t
         }
     }
 
-    // Handle the remaining pixels (fallback to scalar loop)
+    // Handle the remaining pixels (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
     i = num_16pixel_blocks * 16; // Number of processed pixels
-    for(; i < num_pixels; ++i)
-    {
-        rgb[0] = rgba[0]; // Copy R
-        rgb[1] = rgba[1]; // Copy G
-        rgb[2] = rgba[2]; // Copy B
-        rgba += 4;
-        rgb  += 3;
-    }
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
 }
 
-void copy_rgba_to_rgb__avx2__32pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__16pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__avx2__16pixels<rgba_order_t, rgb_order_t>(rgba, rgb, num_pixels);
+}
+
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__32pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
 {
     // Shuffle mask to extract RGB bytes while discarding the Alpha byte
     //
     // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
-    // Each pixel is stored as [R,G,B,A], but we want only [R,G,B]
-    const __m256i shuffle_mask = _mm256_set_epi8(
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0, // Extract 4 RGB from second half
-
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0  // Extract 4 RGB from first half
-    );
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
 
     // Reusable
     __m256i v[4];
@@ -791,31 +1628,27 @@ void copy_rgba_to_rgb__avx2__32pixels(const uint8_t* rgba, uint8_t* rgb, size_t
         }
     }
 
-    // Handle the remaining pixels (fallback to scalar loop)
+    // Handle the remaining pixels (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
     i = num_32pixel_blocks * 32; // Number of processed pixels
-    for(; i < num_pixels; ++i)
-    {
-        rgb[0] = rgba[0]; // Copy R
-        rgb[1] = rgba[1]; // Copy G
-        rgb[2] = rgba[2]; // Copy B
-        rgba += 4;
-        rgb  += 3;
-    }
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
 }
 
-void copy_rgba_to_rgb__avx2__64pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__32pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__avx2__32pixels<rgba_order_t, rgb_order_t>(rgba, rgb, num_pixels);
+}
+
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__64pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
 {
     // Shuffle mask to extract RGB bytes while discarding the Alpha byte
     //
     // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
-    // Each pixel is stored as [R,G,B,A], but we want only [R,G,B]
-    const __m256i shuffle_mask = _mm256_set_epi8(
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0, // Extract 4 RGB from second half
-
-        -1, -1, -1, -1, // `-1` means 'skipped bytes'
-        14,13,12,  10,9,8,  6,5,4,  2,1,0  // Extract 4 RGB from first half
-    );
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
 
     // Reusable
     __m256i v[8];
@@ -1165,130 +1998,6349 @@ void copy_rgba_to_rgb__avx2__64pixels(const uint8_t* rgba, uint8_t* rgb, size_t
         }
     }
 
-    // Handle the remaining pixels (fallback to scalar loop)
+    // Handle the remaining pixels (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
     i = num_64pixel_blocks * 64; // Number of processed pixels
-    for(; i < num_pixels; ++i)
-    {
-        rgb[0] = rgba[0]; // Copy R
-        rgb[1] = rgba[1]; // Copy G
-        rgb[2] = rgba[2]; // Copy B
-        rgba += 4;
-        rgb  += 3;
-    }
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
 }
 
-#endif // defined(__AVX2__)
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__64pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__avx2__64pixels<rgba_order_t, rgb_order_t>(rgba, rgb, num_pixels);
+}
 
-// -----------------------------------------------------------------------------
+/*
+    Packs 4 shuffled (by `copy_rgba_to_rgb__avx2__*` shuffle mask) vectors -
+    32 pixels, 96 useful bytes - into exactly 3 full 32-byte vectors.
 
-int main()
-{
-    print_lscpu();
+    After the in-lane shuffle each vector holds 6 useful dwords (`xx` - junk):
 
-    // Validation
-    if(1)
-    {
-        using test_func_t = void (*) (const uint8_t*, uint8_t*, size_t);
-        using test_name_and_func_t = std::pair< const char*, test_func_t >;
-        const std::vector< test_name_and_func_t > registry
-        {
-              test_name_and_func_t{"memcpy (1 pixel)",       copy_rgba_to_rgb__memcpy}
-            , test_name_and_func_t{"raw_pointers (1 pixel)", copy_rgba_to_rgb__raw_ptr}
-            , test_name_and_func_t{"raw_pointers (4 pixel)", copy_rgba_to_rgb__raw_ptr__4pixels}
+        dword: |  0 |  1 |  2 |  3 |  4 |  5 |  6 |  7 |
+        v[k]:  | k0 | k1 | k2 | xx | k3 | k4 | k5 | xx |
 
-            #if defined(__AVX2__)
-            , test_name_and_func_t{"avx2 (8 pixels)",  copy_rgba_to_rgb__avx2__8pixels}
-            , test_name_and_func_t{"avx2 (16 pixels)", copy_rgba_to_rgb__avx2__16pixels}
-            , test_name_and_func_t{"avx2 (32 pixels)", copy_rgba_to_rgb__avx2__32pixels}
-            , test_name_and_func_t{"avx2 (64 pixels)", copy_rgba_to_rgb__avx2__64pixels}
-            #endif
-        };
+    Lane-crossing `_mm256_permutevar8x32_epi32()` moves them to the positions
+    they occupy in the output, then `_mm256_blend_epi32()` merges neighbours:
 
-        std::vector<size_t> num_pixels_cases;
+        out[0]: | 00 | 01 | 02 | 03 | 04 | 05 | 10 | 11 |  <-- v[0] + v[1]
+        out[1]: | 12 | 13 | 14 | 15 | 20 | 21 | 22 | 23 |  <-- v[1] + v[2]
+        out[2]: | 24 | 25 | 30 | 31 | 32 | 33 | 34 | 35 |  <-- v[2] + v[3]
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline void pack_4x_shuffled_into_3x256__avx2(const __m256i v[4], __m256i out[3])
+{
+    const __m256i p0 = _mm256_permutevar8x32_epi32(v[0], _mm256_setr_epi32(0,1,2,4,5,6, 3,7)); // dwords 6,7 - junk
+    const __m256i p1 = _mm256_permutevar8x32_epi32(v[1], _mm256_setr_epi32(2,4,5,6, 3,7, 0,1)); // dwords 4,5 - junk
+    const __m256i p2 = _mm256_permutevar8x32_epi32(v[2], _mm256_setr_epi32(5,6, 3,7, 0,1,2,4)); // dwords 2,3 - junk
+    const __m256i p3 = _mm256_permutevar8x32_epi32(v[3], _mm256_setr_epi32(3,7, 0,1,2,4,5,6)); // dwords 0,1 - junk
+
+    out[0] = _mm256_blend_epi32(p0, p1, 0xC0); // 0b11000000
+    out[1] = _mm256_blend_epi32(p1, p2, 0xF0); // 0b11110000
+    out[2] = _mm256_blend_epi32(p2, p3, 0xFC); // 0b11111100
+}
+
+/*
+    Same as `copy_rgba_to_rgb__avx2__32pixels()`, but instead of 8 overlapped
+    16-byte stores (where only 12 bytes of each are useful) writes 3 full
+    32-byte stores per 32 pixels.
+
+    Since nothing is written past the 96 bytes of the block, every block is
+    'precise', so there is no need in the separate last block.
+*/
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__32pixels__full_stores(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    //
+    // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
+
+    // Reusable
+    __m256i v[4];
+    __m256i out[3];
+    size_t i = 0;
+
+    const size_t num_32pixel_blocks = num_pixels / 32; //  Process 32 pixels per iteration
+    for(; i < num_32pixel_blocks; ++i)
+    {
+        #if COPY_RGBA_TO_RGB__AVX2__DO_PREFETCH == 1
+        {
+            // (Optional) Prefetching: Load data into (L1) cache before it's needed (improves performance)
+            _mm_prefetch((const char*)(rgba + 128), _MM_HINT_T0); // 128 bytes <-- 32 RGBA pixels * 4 bytes each
+            _mm_prefetch((const char*)(rgb  +  96), _MM_HINT_T0); //  96 bytes of rgb buffer, to write into
+        }
+        #endif
+
+        // ---------------------------------------------------------------------
+
+        // Load (from unaligned memory) 32 RGBA pixels into AVX2 registers
+        v[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba     ));
+        v[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 32));
+        v[2] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 64));
+        v[3] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 96));
+
+        // ---------------------------------------------------------------------
+
+        // Shuffle to discard the Alpha channel, keeping only RGB
+        v[0] = _mm256_shuffle_epi8(v[0], shuffle_mask);
+        v[1] = _mm256_shuffle_epi8(v[1], shuffle_mask);
+        v[2] = _mm256_shuffle_epi8(v[2], shuffle_mask);
+        v[3] = _mm256_shuffle_epi8(v[3], shuffle_mask);
+
+        // ---------------------------------------------------------------------
+
+        // Store the extracted RGB values (exactly 96 bytes will be stored)
+        pack_4x_shuffled_into_3x256__avx2(v, out);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb     ), out[0]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 32), out[1]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 64), out[2]);
+
+        // ---------------------------------------------------------------------
+
+        rgba += 128; // Move forward by 32 pixels in RGBA (32 * 4 = 128)
+        rgb  +=  96; // Move forward by 32 pixels in RGB  (32 * 3 =  96)
+    }
+
+    // Handle the remaining pixels (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
+    i = num_32pixel_blocks * 32; // Number of processed pixels
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__32pixels__full_stores(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__avx2__32pixels__full_stores<rgba_order_t, rgb_order_t>(rgba, rgb, num_pixels);
+}
+
+/*
+    Same as `copy_rgba_to_rgb__avx2__32pixels__full_stores()`, but writes
+    `rgb` by non-temporal (streaming) stores, bypassing the cache.
+
+    Intended for frames larger than the last-level cache: regular stores first
+    read each destination cache line (read-for-ownership) and then evict
+    useful data, to keep the output, which the converter never reads again.
+
+    `_mm256_stream_si256()` requires 32-byte aligned address, so first few
+    (up to 31) pixels are converted by regular stores, until `rgb` becomes aligned.
+    Since 96 bytes are written per block, it stays aligned after each block.
+*/
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__stream(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    //
+    // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
+
+    // Reusable
+    __m256i v[4];
+    __m256i out[3];
+    size_t i = 0;
+
+    // Number of pixels to skip, until `rgb` becomes 32-byte aligned:
+    //   (rgb + 3 * k) % 32 == 0  -->  k = (-rgb * 11) % 32, since 3 * 11 = 33 = 1 (mod 32)
+    const size_t misalignment = reinterpret_cast<uintptr_t>(rgb) % 32;
+    size_t num_head_pixels = (((32 - misalignment) % 32) * 11) % 32;
+    if(num_head_pixels > num_pixels)
+    {
+        num_head_pixels = num_pixels;
+    }
+
+    // Head is converted by regular stores (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_head_pixels, 0, shuffle_mask);
+    rgba += num_head_pixels * 4;
+    rgb  += num_head_pixels * 3;
+
+    const size_t num_32pixel_blocks = (num_pixels - num_head_pixels) / 32; //  Process 32 pixels per iteration
+    for(size_t block = 0; block < num_32pixel_blocks; ++block)
+    {
+        // Load (from unaligned memory) 32 RGBA pixels into AVX2 registers
+        v[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba     ));
+        v[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 32));
+        v[2] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 64));
+        v[3] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 96));
+
+        // ---------------------------------------------------------------------
+
+        // Shuffle to discard the Alpha channel, keeping only RGB
+        v[0] = _mm256_shuffle_epi8(v[0], shuffle_mask);
+        v[1] = _mm256_shuffle_epi8(v[1], shuffle_mask);
+        v[2] = _mm256_shuffle_epi8(v[2], shuffle_mask);
+        v[3] = _mm256_shuffle_epi8(v[3], shuffle_mask);
+
+        // ---------------------------------------------------------------------
+
+        // Store the extracted RGB values (exactly 96 bytes, into aligned memory, bypassing cache)
+        pack_4x_shuffled_into_3x256__avx2(v, out);
+
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(rgb     ), out[0]);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(rgb + 32), out[1]);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(rgb + 64), out[2]);
+
+        // ---------------------------------------------------------------------
+
+        rgba += 128; // Move forward by 32 pixels in RGBA (32 * 4 = 128)
+        rgb  +=  96; // Move forward by 32 pixels in RGB  (32 * 3 =  96)
+    }
+
+    // Handle the remaining pixels (vectorized, see `copy_rgba_to_rgb__avx2__tail()`)
+    i = num_head_pixels + num_32pixel_blocks * 32; // Number of processed pixels
+    copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
+
+    // Streaming stores are weakly-ordered: make them visible before any
+    // subsequent store (for example - 'frame is ready' flag for other thread)
+    _mm_sfence();
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__stream(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_4ch_to_3ch__avx2__stream<rgba_order_t, rgb_order_t>(rgba, rgb, num_pixels);
+}
+
+/*
+    Converts single image row of `width` pixels, knowing that `dst_slack`
+    bytes after the end of the row in `rgb` (row padding) may be clobbered.
+
+    Differences from `copy_rgba_to_rgb__avx2__8pixels()`:
+      - Last block uses overlapping store, if junk bytes fall into the rest of
+        the row or into its padding, instead of always being precise.
+      - Remainder (`width % 8` pixels) is converted by one more 8-pixel block,
+        aligned to the end of the row and stored with respect to `dst_slack`.
+        Rows, narrower than 8 pixels, are converted by masked load/store.
+*/
+template<typename SrcOrder, typename DstOrder>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_4ch_to_3ch__avx2__row(const uint8_t* rgba, uint8_t* rgb, size_t width, size_t dst_slack)
+{
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    //
+    // The shuffle mask defines how bytes are rearranged in `__m256i` (32-byte) AVX2 registers.
+    // Each pixel is stored as [R,G,B,A] (in `SrcOrder`), but we want only [R,G,B] (in `DstOrder`).
+    // For RGBA --> RGB it's `-1,-1,-1,-1, 14,13,12, 10,9,8, 6,5,4, 2,1,0` in each half.
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<SrcOrder, DstOrder>();
+
+    const size_t num_8pixel_blocks = width / 8;
+    if(num_8pixel_blocks == 0)
+    {
+        // Too narrow row (masked load/store)
+        copy_rgba_to_rgb__avx2__block8__masked(rgba, rgb, width, shuffle_mask);
+        return;
+    }
+
+    const uint8_t* const rgba_row = rgba;
+    uint8_t*       const rgb_row  = rgb;
+
+    // All but the last block: at least 8 more pixels follow, junk is always overwritten
+    for(size_t i = 0; i < (num_8pixel_blocks - 1); ++i)
+    {
+        copy_rgba_to_rgb__avx2__block8__overlapping(rgba, rgb, shuffle_mask);
+        rgba += 32; // Move forward by 8 pixels in RGBA (8 * 4 = 32)
+        rgb  += 24; // Move forward by 8 pixels in RGB  (8 * 3 = 24)
+    }
+
+    // Last block: 4 junk bytes land into remaining pixels and/or row padding
+    const size_t num_remaining_pixels = width % 8;
+    if( ((num_remaining_pixels * 3) + dst_slack) >= 4 )
+    {
+        copy_rgba_to_rgb__avx2__block8__overlapping(rgba, rgb, shuffle_mask);
+    }
+    else
+    {
+        copy_rgba_to_rgb__avx2__block8__precise(rgba, rgb, shuffle_mask);
+    }
+
+    // Remainder: last 8 pixels of the row (overlapped with already converted ones)
+    if(num_remaining_pixels > 0)
+    {
+        const size_t last_block = width - 8;
+        if(dst_slack >= 4)
+        {
+            copy_rgba_to_rgb__avx2__block8__overlapping(rgba_row + (last_block * 4), rgb_row + (last_block * 3), shuffle_mask);
+        }
+        else
+        {
+            copy_rgba_to_rgb__avx2__block8__precise(rgba_row + (last_block * 4), rgb_row + (last_block * 3), shuffle_mask);
+        }
+    }
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__row(const uint8_t* rgba, uint8_t* rgb, size_t width, size_t dst_slack)
+{
+    copy_4ch_to_3ch__avx2__row<rgba_order_t, rgb_order_t>(rgba, rgb, width, dst_slack);
+}
+
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+// -----------------------------------------------------------------------------
+
+using copy_rgba_to_rgb_func_t = void (*) (const uint8_t*, uint8_t*, size_t);
+
+struct copy_rgba_to_rgb_impl_t
+{
+    const char*             name;
+    copy_rgba_to_rgb_func_t func;
+};
+
+/*
+    Picks the fastest kernel, supported by the current CPU.
+
+    Order of preference is based on benchmark results (see README.md): all AVX2
+    variants are close, but `32 pixels` one is slightly ahead. Then SSSE3, and
+    portable SWAR kernel as the last resort.
+*/
+copy_rgba_to_rgb_impl_t resolve_copy_rgba_to_rgb()
+{
+    const cpu_features_t& features = get_cpu_features();
+
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(features.avx2)
+    {
+        return copy_rgba_to_rgb_impl_t{"avx2 (32 pixels)", copy_rgba_to_rgb__avx2__32pixels};
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    #if COPY_RGBA_TO_RGB__HAS_SSSE3
+    if(features.ssse3)
+    {
+        return copy_rgba_to_rgb_impl_t{"ssse3 (32 pixels)", copy_rgba_to_rgb__ssse3__32pixels};
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_SSSE3
+
+    (void)features;
+    return copy_rgba_to_rgb_impl_t{"swar (4 pixels)", copy_rgba_to_rgb__swar__4pixels};
+}
+
+// Kernel with non-temporal stores, or `nullptr` if not supported by CPU
+copy_rgba_to_rgb_impl_t resolve_copy_rgba_to_rgb__stream()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        return copy_rgba_to_rgb_impl_t{"avx2 (streaming stores)", copy_rgba_to_rgb__avx2__stream};
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_rgb_impl_t{nullptr, nullptr};
+}
+
+/*
+    Frames, which together with their output (4 + 3 bytes per pixel) do not fit
+    into this size, are converted with streaming stores in `store_mode_t::automatic`.
+
+    Can be overridden at compile time, by default - size of the last-level cache.
+*/
+size_t detect_copy_rgba_to_rgb_streaming_threshold()
+{
+    #if defined(COPY_RGBA_TO_RGB__STREAMING_THRESHOLD_BYTES)
+        return COPY_RGBA_TO_RGB__STREAMING_THRESHOLD_BYTES;
+    #else
+        return detect_last_level_cache_size();
+    #endif
+}
+
+// Resolved once, at startup (during static initialization)
+static const copy_rgba_to_rgb_impl_t g_copy_rgba_to_rgb_impl         = resolve_copy_rgba_to_rgb();
+static const copy_rgba_to_rgb_impl_t g_copy_rgba_to_rgb_impl__stream = resolve_copy_rgba_to_rgb__stream();
+static const size_t g_copy_rgba_to_rgb_streaming_threshold = detect_copy_rgba_to_rgb_streaming_threshold();
+
+const char* copy_rgba_to_rgb_impl_name()
+{
+    return g_copy_rgba_to_rgb_impl.name;
+}
+
+size_t copy_rgba_to_rgb_streaming_threshold()
+{
+    return g_copy_rgba_to_rgb_streaming_threshold;
+}
+
+enum class store_mode_t
+{
+    automatic, // Streaming stores for frames larger than `copy_rgba_to_rgb_streaming_threshold()`
+    regular,   // Always regular (cached) stores
+    streaming  // Always non-temporal stores (if supported by CPU)
+};
+
+/*
+    Public entry point: converts `num_pixels` RGBA pixels into RGB pixels,
+    using the best kernel for the current CPU.
+
+    Dispatch overhead is a single indirect call per invocation (not per pixel).
+*/
+void copy_rgba_to_rgb(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels, store_mode_t store_mode)
+{
+    const bool use_streaming =
+        (g_copy_rgba_to_rgb_impl__stream.func != nullptr) &&
+        (
+            (store_mode == store_mode_t::streaming) ||
+            (
+                (store_mode == store_mode_t::automatic) &&
+                (num_pixels * (4 + 3) > g_copy_rgba_to_rgb_streaming_threshold)
+            )
+        );
+
+    if(use_streaming)
+    {
+        g_copy_rgba_to_rgb_impl__stream.func(rgba, rgb, num_pixels);
+    }
+    else
+    {
+        g_copy_rgba_to_rgb_impl.func(rgba, rgb, num_pixels);
+    }
+}
+
+void copy_rgba_to_rgb(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_rgba_to_rgb(rgba, rgb, num_pixels, store_mode_t::automatic);
+}
+
+/*
+    Same as `copy_rgba_to_rgb()`, but for any channel orders, for example:
+
+        copy_4ch_to_3ch<bgra_order_t, rgb_order_t>(bgra, rgb, num_pixels);
+
+    Each instantiation has its own compile-time shuffle mask, so it runs at the
+    same speed as RGBA --> RGB (no second swizzle pass).
+*/
+template<typename SrcOrder, typename DstOrder>
+void copy_4ch_to_3ch(const uint8_t* src, uint8_t* dst, size_t num_pixels)
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        copy_4ch_to_3ch__avx2__32pixels<SrcOrder, DstOrder>(src, dst, num_pixels);
+        return;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    #if COPY_RGBA_TO_RGB__HAS_SSSE3
+    if(get_cpu_features().ssse3)
+    {
+        copy_4ch_to_3ch__ssse3<SrcOrder, DstOrder, 32>(src, dst, num_pixels);
+        return;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_SSSE3
+
+    copy_4ch_to_3ch__raw_ptr<SrcOrder, DstOrder>(src, dst, num_pixels);
+}
+
+// -----------------------------------------------------------------------------
+
+/*
+    Persistent pool of worker threads.
+
+    Threads are created once and sleep on condition variable between jobs, so
+    per-call cost is wake-up latency, instead of thread creation.
+
+    The calling thread also participates in the job, so pool of `N` threads
+    owns only `N - 1` workers.
+*/
+class thread_pool_t
+{
+public:
+    using task_func_t = std::function<void(size_t)>;
+
+    explicit thread_pool_t(size_t num_threads)
+    {
+        num_threads = std::max<size_t>(num_threads, 1);
+        for(size_t i = 1; i < num_threads; ++i)
+        {
+            m_workers.emplace_back(&thread_pool_t::worker_loop, this);
+        }
+    }
+
+    ~thread_pool_t()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv_start.notify_all();
+
+        for(std::thread& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    thread_pool_t(const thread_pool_t&) = delete;
+    thread_pool_t& operator=(const thread_pool_t&) = delete;
+
+    // Including the calling thread
+    size_t num_threads() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    // Calls `func(task_index)` for each index in `[0, num_tasks)`, blocks until all are done
+    void parallel_for(size_t num_tasks, const task_func_t& func)
+    {
+        if( m_workers.empty() || (num_tasks <= 1) )
+        {
+            for(size_t i = 0; i < num_tasks; ++i)
+            {
+                func(i);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> submit_lock(m_submit_mutex); // One job at a time
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_func        = &func;
+            m_num_tasks   = num_tasks;
+            m_next_task   = 0;
+            m_num_working = m_workers.size();
+            ++m_generation;
+        }
+        m_cv_start.notify_all();
+
+        run_tasks();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv_done.wait(lock, [this]() { return m_num_working == 0; });
+        m_func = nullptr;
+    }
+
+private:
+    // Tasks are claimed one by one, so faster threads take more of them
+    void run_tasks()
+    {
+        for(;;)
+        {
+            const size_t task_index = m_next_task.fetch_add(1);
+            if(task_index >= m_num_tasks)
+            {
+                break;
+            }
+            (*m_func)(task_index);
+        }
+    }
+
+    void worker_loop()
+    {
+        uint64_t seen_generation = 0;
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv_start.wait(lock, [&]() { return m_stop || (m_generation != seen_generation); });
+                if(m_stop)
+                {
+                    return;
+                }
+                seen_generation = m_generation;
+            }
+
+            run_tasks();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if(--m_num_working == 0)
+                {
+                    m_cv_done.notify_one();
+                }
+            }
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex              m_submit_mutex;
+    std::mutex              m_mutex;
+    std::condition_variable m_cv_start;
+    std::condition_variable m_cv_done;
+
+    const task_func_t*  m_func        = nullptr;
+    size_t              m_num_tasks   = 0;
+    std::atomic<size_t> m_next_task   {0};
+    size_t              m_num_working = 0;
+    uint64_t            m_generation  = 0;
+    bool                m_stop        = false;
+};
+
+// -----------------------------------------------------------------------------
+
+#if !defined(COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS)
+    // 16K pixels --> 64 KiB of RGBA + 48 KiB of RGB per chunk (fits into L2)
+    #define COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS (16 * 1024)
+#endif
+
+/*
+    Chunks are multiple of the largest kernel block (64 pixels, see
+    `copy_rgba_to_rgb__avx2__64pixels()`), so every chunk, except the very last
+    one, is converted by whole blocks, without scalar remainder loop.
+*/
+static_assert((COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS % 64) == 0, "Chunk must be multiple of 64 pixels");
+
+std::unique_ptr<thread_pool_t>& copy_rgba_to_rgb_parallel_pool()
+{
+    static std::unique_ptr<thread_pool_t> pool(
+        new thread_pool_t( std::max<size_t>(std::thread::hardware_concurrency(), 1) )
+    );
+    return pool;
+}
+
+size_t copy_rgba_to_rgb_parallel_num_threads()
+{
+    return copy_rgba_to_rgb_parallel_pool()->num_threads();
+}
+
+/*
+    Recreates the pool with `num_threads` threads (including the calling one).
+
+    NOTE: must not be called concurrently with `copy_rgba_to_rgb_parallel()`.
+*/
+void copy_rgba_to_rgb_parallel_set_num_threads(size_t num_threads)
+{
+    std::unique_ptr<thread_pool_t>& pool = copy_rgba_to_rgb_parallel_pool();
+    if(pool->num_threads() != num_threads)
+    {
+        pool.reset(); // Join old workers first
+        pool.reset(new thread_pool_t(num_threads));
+    }
+}
+
+/*
+    Same as `copy_rgba_to_rgb()`, but splits the frame into chunks of
+    `COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS` and converts them on the
+    persistent thread pool.
+
+    Store mode is chosen once for the whole frame (not per chunk), since it's
+    the frame size which decides, if output stays in cache.
+*/
+void copy_rgba_to_rgb_parallel(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels, store_mode_t store_mode)
+{
+    static constexpr size_t CHUNK_PIXELS = COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS;
+
+    if(store_mode == store_mode_t::automatic)
+    {
+        store_mode = (num_pixels * (4 + 3) > copy_rgba_to_rgb_streaming_threshold())
+            ? store_mode_t::streaming
+            : store_mode_t::regular;
+    }
+
+    const size_t num_chunks = (num_pixels + CHUNK_PIXELS - 1) / CHUNK_PIXELS;
+
+    copy_rgba_to_rgb_parallel_pool()->parallel_for(num_chunks, [&](size_t chunk_index) {
+        const size_t begin = chunk_index * CHUNK_PIXELS;
+        const size_t count = std::min(CHUNK_PIXELS, num_pixels - begin);
+        copy_rgba_to_rgb(rgba + (begin * 4), rgb + (begin * 3), count, store_mode);
+    });
+}
+
+void copy_rgba_to_rgb_parallel(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_rgba_to_rgb_parallel(rgba, rgb, num_pixels, store_mode_t::automatic);
+}
+
+// -----------------------------------------------------------------------------
+// Batch conversion: many small images in one call
+
+// One image of a batch, see `copy_rgba_to_rgb_batch()`
+struct copy_rgba_to_rgb_job_t
+{
+    const uint8_t* rgba;
+    uint8_t*       rgb;
+    size_t         num_pixels;
+};
+
+// Portable: back-to-back calls of the dispatched kernel (without per-image store mode choice)
+void copy_rgba_to_rgb__batch__dispatched(const copy_rgba_to_rgb_job_t* jobs, size_t num_jobs)
+{
+    const copy_rgba_to_rgb_func_t func = g_copy_rgba_to_rgb_impl.func;
+    for(size_t j = 0; j < num_jobs; ++j)
+    {
+        func(jobs[j].rgba, jobs[j].rgb, jobs[j].num_pixels);
+    }
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+/*
+    All images of the batch in one function: shuffle mask is loaded once,
+    there are no indirect calls, and blocks of 32 pixels (with full 32-byte
+    stores) are followed by vectorized tail. The first cache line of the next
+    image is prefetched, while the current one is converted.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb__avx2__batch(const copy_rgba_to_rgb_job_t* jobs, size_t num_jobs)
+{
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<rgba_order_t, rgb_order_t>();
+
+    __m256i v[4];
+    __m256i out[3];
+
+    for(size_t j = 0; j < num_jobs; ++j)
+    {
+        if(j + 1 < num_jobs)
+        {
+            _mm_prefetch((const char*)(jobs[j + 1].rgba), _MM_HINT_T0);
+        }
+
+        const uint8_t* rgba       = jobs[j].rgba;
+        uint8_t*       rgb        = jobs[j].rgb;
+        const size_t   num_pixels = jobs[j].num_pixels;
+
+        const size_t num_32pixel_blocks = num_pixels / 32;
+        for(size_t i = 0; i < num_32pixel_blocks; ++i)
+        {
+            v[0] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba     )), shuffle_mask);
+            v[1] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 32)), shuffle_mask);
+            v[2] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 64)), shuffle_mask);
+            v[3] = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 96)), shuffle_mask);
+
+            pack_4x_shuffled_into_3x256__avx2(v, out);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb     ), out[0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 32), out[1]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 64), out[2]);
+
+            rgba += 128; // Move forward by 32 pixels in RGBA (32 * 4 = 128)
+            rgb  +=  96; // Move forward by 32 pixels in RGB  (32 * 3 =  96)
+        }
+
+        const size_t i = num_32pixel_blocks * 32; // Number of processed pixels
+        copy_rgba_to_rgb__avx2__tail(rgba, rgb, num_pixels - i, i, shuffle_mask);
+    }
+}
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+using copy_rgba_to_rgb_batch_func_t = void (*) (const copy_rgba_to_rgb_job_t*, size_t);
+
+copy_rgba_to_rgb_batch_func_t resolve_copy_rgba_to_rgb_batch()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        return copy_rgba_to_rgb__avx2__batch;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_rgb__batch__dispatched;
+}
+
+// Resolved once, at startup (during static initialization)
+static const copy_rgba_to_rgb_batch_func_t g_copy_rgba_to_rgb_batch_impl = resolve_copy_rgba_to_rgb_batch();
+
+/*
+    Converts `num_jobs` independent images (sprites, thumbnails, tiles) in
+    one call. Meant for small images: always regular stores (output of
+    batch usually stays in cache), use `copy_rgba_to_rgb()` for frames.
+*/
+void copy_rgba_to_rgb_batch(const copy_rgba_to_rgb_job_t* jobs, size_t num_jobs)
+{
+    g_copy_rgba_to_rgb_batch_impl(jobs, num_jobs);
+}
+
+/*
+    Same as `copy_rgba_to_rgb_batch()`, but spreads the batch over the thread
+    pool of `copy_rgba_to_rgb_parallel()`: jobs are split into consecutive
+    groups of about `COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS` pixels (a single
+    large image is never split).
+*/
+void copy_rgba_to_rgb_batch_parallel(const copy_rgba_to_rgb_job_t* jobs, size_t num_jobs)
+{
+    static constexpr size_t CHUNK_PIXELS = COPY_RGBA_TO_RGB__PARALLEL__CHUNK_PIXELS;
+
+    std::vector<size_t> group_begins{0};
+    size_t group_pixels = 0;
+    for(size_t j = 0; j < num_jobs; ++j)
+    {
+        group_pixels += jobs[j].num_pixels;
+        if((group_pixels >= CHUNK_PIXELS) && (j + 1 < num_jobs))
+        {
+            group_begins.push_back(j + 1);
+            group_pixels = 0;
+        }
+    }
+    group_begins.push_back(num_jobs);
+
+    copy_rgba_to_rgb_parallel_pool()->parallel_for(group_begins.size() - 1, [&](size_t group_index) {
+        const size_t begin = group_begins[group_index];
+        g_copy_rgba_to_rgb_batch_impl(jobs + begin, group_begins[group_index + 1] - begin);
+    });
+}
+
+// -----------------------------------------------------------------------------
+
+using copy_rgba_to_rgb_row_func_t = void (*) (const uint8_t*, uint8_t*, size_t, size_t);
+
+// Without AVX2 row padding is not used: the whole row goes to the dispatched kernel (SSSE3, or SWAR)
+void copy_rgba_to_rgb__dispatched__row(const uint8_t* rgba, uint8_t* rgb, size_t width, size_t /*dst_slack*/)
+{
+    g_copy_rgba_to_rgb_impl.func(rgba, rgb, width);
+}
+
+copy_rgba_to_rgb_row_func_t resolve_copy_rgba_to_rgb_row()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        return copy_rgba_to_rgb__avx2__row;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_rgb__dispatched__row;
+}
+
+// Resolved once, at startup (during static initialization)
+static const copy_rgba_to_rgb_row_func_t g_copy_rgba_to_rgb_row_impl = resolve_copy_rgba_to_rgb_row();
+
+/*
+    Converts `width` x `height` image with arbitrary row pitches (in bytes).
+
+    Pitches are signed, negative pitch means bottom-up image (`src`/`dst`
+    points to the row 0, which is the last one in memory order).
+
+      - Contiguous images (`src_pitch == width * 4`, `dst_pitch == width * 3`)
+        are converted by a single `copy_rgba_to_rgb()` call.
+      - Otherwise - row by row. Row padding in `dst` (if it's at least 4 bytes)
+        is used as a 'scratch' for overlapping stores, so it may be clobbered
+        (except the padding after the row at the highest address - it may not
+        belong to buffer: that's the last row, or the row 0 for negative pitch).
+        Without AVX2 rows go to the same kernel as `copy_rgba_to_rgb()`.
+*/
+void copy_rgba_to_rgb_2d(
+    const uint8_t* src, ptrdiff_t src_pitch,
+    uint8_t*       dst, ptrdiff_t dst_pitch,
+    size_t width, size_t height)
+{
+    if( (width == 0) || (height == 0) )
+    {
+        return;
+    }
+
+    const ptrdiff_t src_row_bytes = static_cast<ptrdiff_t>(width * 4);
+    const ptrdiff_t dst_row_bytes = static_cast<ptrdiff_t>(width * 3);
+
+    if( (src_pitch == src_row_bytes) && (dst_pitch == dst_row_bytes) )
+    {
+        copy_rgba_to_rgb(src, dst, width * height);
+        return;
+    }
+
+    const ptrdiff_t dst_abs_pitch = (dst_pitch < 0) ? -dst_pitch : dst_pitch;
+    const size_t    dst_slack     = (dst_abs_pitch > dst_row_bytes) ? static_cast<size_t>(dst_abs_pitch - dst_row_bytes) : 0;
+
+    for(size_t y = 0; y < height; ++y)
+    {
+        const bool is_highest_row = (dst_pitch < 0) ? (y == 0) : (y == (height - 1));
+        g_copy_rgba_to_rgb_row_impl(src, dst, width, is_highest_row ? 0 : dst_slack);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+
+/*
+    Converts bottom-up `width` x `height` RGBA image (`glReadPixels()`, DIBs,
+    many capture APIs) into top-down RGB image, in one pass: source rows are
+    read from the last one to the first, destination rows are written in
+    order. A thin wrapper: `copy_rgba_to_rgb_2d()` with negative source pitch,
+    so rows are converted by its row kernel, and the flip itself costs nothing.
+    Pitches are positive, `src` is the buffer start.
+*/
+void copy_rgba_to_rgb_flip_vertical(
+    const uint8_t* src, size_t src_pitch,
+    uint8_t*       dst, size_t dst_pitch,
+    size_t width, size_t height)
+{
+    if(height == 0)
+    {
+        return;
+    }
+
+    const uint8_t* last_src_row = src + ((height - 1) * src_pitch);
+    copy_rgba_to_rgb_2d(last_src_row, -static_cast<ptrdiff_t>(src_pitch), dst, static_cast<ptrdiff_t>(dst_pitch), width, height);
+}
+
+// -----------------------------------------------------------------------------
+// Fused conversion with 2x downscale (box filter): RGBA to half-resolution RGB
+//
+// Output pixel is the rounded average of 2x2 input block: `(a + b + c + d + 2) / 4`,
+// per channel. Output is `width / 2` x `height / 2` (odd last column/row is dropped).
+
+using copy_rgba_to_rgb_downscale_2x_func_t = void (*) (const uint8_t*, ptrdiff_t, uint8_t*, ptrdiff_t, size_t, size_t);
+
+void copy_rgba_to_rgb_downscale_2x__raw_ptr(
+    const uint8_t* src, ptrdiff_t src_pitch,
+    uint8_t*       dst, ptrdiff_t dst_pitch,
+    size_t width, size_t height)
+{
+    const size_t out_width  = width  / 2;
+    const size_t out_height = height / 2;
+
+    for(size_t y = 0; y < out_height; ++y)
+    {
+        const uint8_t* row0 = src + (static_cast<ptrdiff_t>(2 * y) * src_pitch);
+        const uint8_t* row1 = row0 + src_pitch;
+        uint8_t*       rgb  = dst + (static_cast<ptrdiff_t>(y) * dst_pitch);
+
+        for(size_t x = 0; x < out_width; ++x)
+        {
+            for(size_t c = 0; c < 3; ++c)
+            {
+                rgb[c] = static_cast<uint8_t>((row0[c] + row0[4 + c] + row1[c] + row1[4 + c] + 2) >> 2);
+            }
+            row0 += 8; // 2 RGBA pixels
+            row1 += 8;
+            rgb  += 3;
+        }
+    }
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+/*
+    Averages 2x2 blocks of 16 + 16 RGBA pixels (`row0`, `row1`) into 8 RGBA
+    pixels. Sums are 16-bit, so rounding is exact (unlike two rounds of
+    `_mm256_avg_epu8()`, which is biased up):
+
+      - Zero-extension of bytes by unpack gives pixels 0,1 / 2,3 of each lane
+        (4 pixels), vertical sums are 16-bit adds.
+      - 64-bit unpacks pair horizontal neighbours: [0+1, 2+3] per lane.
+      - Pack back to bytes interleaves lanes, 64-bit permute restores order.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline __m256i downscale_2x2_16pixels__avx2(const uint8_t* row0, const uint8_t* row1)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i two  = _mm256_set1_epi16(2); // For rounding
+
+    __m256i half[2]; // Output pixels 0,1 | 2,3 and 4,5 | 6,7 (low | high lane), 16-bit channels
+    for(size_t h = 0; h < 2; ++h)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + (h * 32)));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + (h * 32)));
+
+        const __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)); // Pixels 0,1 (per lane)
+        const __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)); // Pixels 2,3 (per lane)
+
+        const __m256i sum = _mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), _mm256_unpackhi_epi64(lo, hi));
+        half[h] = _mm256_srli_epi16(_mm256_add_epi16(sum, two), 2);
+    }
+
+    // Qwords: [0,1 | 4,5 | 2,3 | 6,7] --> [0,1 | 2,3 | 4,5 | 6,7]
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(half[0], half[1]), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+/*
+    Each row: blocks of 8 output pixels (16 + 16 input), shuffled by the same
+    mask as `copy_rgba_to_rgb__avx2__*()` kernels. Overlapping stores, except
+    the last block of the row, which is precise. Remainder of 1..7 output
+    pixels is converted by one more block, aligned to the end of the row.
+    Rows narrower than 8 output pixels are converted by scalar code.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_rgb_downscale_2x__avx2(
+    const uint8_t* src, ptrdiff_t src_pitch,
+    uint8_t*       dst, ptrdiff_t dst_pitch,
+    size_t width, size_t height)
+{
+    const size_t out_width  = width  / 2;
+    const size_t out_height = height / 2;
+
+    if(out_width < 8)
+    {
+        copy_rgba_to_rgb_downscale_2x__raw_ptr(src, src_pitch, dst, dst_pitch, width, height);
+        return;
+    }
+
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<rgba_order_t, rgb_order_t>();
+
+    const size_t num_blocks = out_width / 8;
+    const size_t last_block = out_width - 8; // First output pixel of the end-aligned block
+
+    for(size_t y = 0; y < out_height; ++y)
+    {
+        const uint8_t* row0 = src + (static_cast<ptrdiff_t>(2 * y) * src_pitch);
+        const uint8_t* row1 = row0 + src_pitch;
+        uint8_t*       rgb  = dst + (static_cast<ptrdiff_t>(y) * dst_pitch);
+
+        for(size_t i = 0; i < num_blocks; ++i)
+        {
+            const __m256i v = _mm256_shuffle_epi8(downscale_2x2_16pixels__avx2(row0 + (i * 64), row1 + (i * 64)), shuffle_mask);
+
+            // 4 junk bytes fit into the next (at least 2) pixels of the row
+            if(out_width - (i * 8) >= 10)
+            {
+                store_8rgb_pixels__avx2__overlapping(rgb + (i * 24), v);
+            }
+            else
+            {
+                store_8rgb_pixels__avx2__precise(rgb + (i * 24), v);
+            }
+        }
+
+        if((out_width % 8) != 0)
+        {
+            const __m256i v = _mm256_shuffle_epi8(downscale_2x2_16pixels__avx2(row0 + (last_block * 8), row1 + (last_block * 8)), shuffle_mask);
+            store_8rgb_pixels__avx2__precise(rgb + (last_block * 3), v);
+        }
+    }
+}
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+copy_rgba_to_rgb_downscale_2x_func_t resolve_copy_rgba_to_rgb_downscale_2x()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        return copy_rgba_to_rgb_downscale_2x__avx2;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_rgb_downscale_2x__raw_ptr;
+}
+
+// Resolved once, at startup (during static initialization)
+static const copy_rgba_to_rgb_downscale_2x_func_t g_copy_rgba_to_rgb_downscale_2x_impl = resolve_copy_rgba_to_rgb_downscale_2x();
+
+/*
+    Converts `width` x `height` RGBA image into `width / 2` x `height / 2`
+    RGB image (2x2 box filter) in one pass, without full-resolution RGB
+    intermediate. Pitches - as in `copy_rgba_to_rgb_2d()`.
+*/
+void copy_rgba_to_rgb_downscale_2x(
+    const uint8_t* src, ptrdiff_t src_pitch,
+    uint8_t*       dst, ptrdiff_t dst_pitch,
+    size_t width, size_t height)
+{
+    g_copy_rgba_to_rgb_downscale_2x_impl(src, src_pitch, dst, dst_pitch, width, height);
+}
+
+// Second pass of the two-pass equivalent (convert, then downscale RGB), for validation and benchmarks
+void downscale_2x_rgb__raw_ptr(
+    const uint8_t* src, ptrdiff_t src_pitch,
+    uint8_t*       dst, ptrdiff_t dst_pitch,
+    size_t width, size_t height)
+{
+    const size_t out_width  = width  / 2;
+    const size_t out_height = height / 2;
+
+    for(size_t y = 0; y < out_height; ++y)
+    {
+        const uint8_t* row0 = src + (static_cast<ptrdiff_t>(2 * y) * src_pitch);
+        const uint8_t* row1 = row0 + src_pitch;
+        uint8_t*       rgb  = dst + (static_cast<ptrdiff_t>(y) * dst_pitch);
+
+        for(size_t x = 0; x < out_width; ++x)
+        {
+            for(size_t c = 0; c < 3; ++c)
+            {
+                rgb[c] = static_cast<uint8_t>((row0[c] + row0[3 + c] + row1[c] + row1[3 + c] + 2) >> 2);
+            }
+            row0 += 6; // 2 RGB pixels
+            row1 += 6;
+            rgb  += 3;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+// RGBA to YUV 4:2:0 (I420 - 3 planes, NV12 - Y plane + interleaved UV plane)
+//
+// Y is per pixel, U and V - per 2x2 block (from the average of its 4 pixels).
+// Odd last column/row: chroma is from the existing pixels of the block.
+
+enum class yuv_matrix_t
+{
+    bt601, // SD
+    bt709, // HD
+};
+
+enum class yuv_range_t
+{
+    limited, // Y: 16..235, U/V: 16..240 ("TV", what most encoders expect)
+    full,    // Y, U, V: 0..255 ("PC", JPEG)
+};
+
+/*
+    Fixed-point coefficients:
+
+      - Y: 8-bit fraction, applied by `_mm256_maddubs_epi16()` (unsigned bytes
+        x signed bytes, adjacent products summed into 16 bits). Pixel bytes are
+        shuffled into (R, G, B, G), and G weight is split into `y_g1 + y_g2`,
+        so every weight fits into int8, and no pair sum overflows int16:
+        `255 * (y_r + y_g1) <= 32767`, `255 * (y_b + y_g2) <= 32767`.
+        With 8 bits weight rounding alone costs up to ~0.5, so the rounding
+        constant is tuned too, to stay within +-1 of the exact formula.
+      - U, V: 14-bit fraction, applied by `_mm256_madd_epi16()` to 16-bit sums
+        of 2x2 blocks (so the shift is 14 + 2). Weights sum to 0 (gray is 128).
+*/
+struct yuv_coefficients_t
+{
+    int8_t   y_r, y_g1, y_b, y_g2;
+    uint16_t y_rounding;
+    int      y_offset; // 16 (limited) or 0 (full)
+
+    int16_t u_r, u_g, u_b;
+    int16_t v_r, v_g, v_b;
+};
+
+yuv_coefficients_t make_yuv_coefficients(yuv_matrix_t matrix, yuv_range_t range)
+{
+    const double kr = (matrix == yuv_matrix_t::bt601) ? 0.299 : 0.2126;
+    const double kb = (matrix == yuv_matrix_t::bt601) ? 0.114 : 0.0722;
+    const double kg = 1.0 - kr - kb;
+
+    const double y_scale  = (range == yuv_range_t::limited) ? (219.0 / 255.0) : 1.0;
+    const double uv_scale = (range == yuv_range_t::limited) ? (224.0 / 255.0) : 1.0;
+
+    /*
+        Y: each weight is rounded down or up, and rounding constant is chosen,
+        to minimize the worst error against the exact formula. The error is
+        linear in (R, G, B), so it peaks at corners of the RGB cube: sum of
+        positive (or negative) weight errors * 255, plus [-1, 0) of the shift.
+    */
+    const double exact[3] = { kr * y_scale * 256.0, kg * y_scale * 256.0, kb * y_scale * 256.0 };
+
+    yuv_coefficients_t c{};
+    double             min_error = 1e9;
+    for(int rounding = 0; rounding < 8; ++rounding)
+    {
+        int weights[3];
+        double error_positive = 0.0;
+        double error_negative = 0.0;
+        for(int i = 0; i < 3; ++i)
+        {
+            weights[i] = static_cast<int>(std::floor(exact[i])) + ((rounding >> i) & 1);
+
+            const double error = (weights[i] - exact[i]) * 255.0 / 256.0;
+            (error > 0.0 ? error_positive : error_negative) += error;
+        }
+
+        // G weight split: pairs of `_mm256_maddubs_epi16()` must not saturate
+        const int g1 = std::min(127, 128 - weights[0]);
+        const int g2 = weights[1] - g1;
+        if((g2 > 127) || ((weights[2] + g2) > 128))
+        {
+            continue;
+        }
+
+        // 16-bit sum must not wrap
+        const int max_constant = 65535 - ((weights[0] + weights[1] + weights[2]) * 255);
+        for(int constant = 0; constant <= std::min(511, max_constant); ++constant)
+        {
+            const double error = std::max(error_positive + (constant / 256.0), 1.0 - error_negative - (constant / 256.0));
+            if(error < min_error)
+            {
+                min_error    = error;
+                c.y_r        = static_cast<int8_t>(weights[0]);
+                c.y_g1       = static_cast<int8_t>(g1);
+                c.y_b        = static_cast<int8_t>(weights[2]);
+                c.y_g2       = static_cast<int8_t>(g2);
+                c.y_rounding = static_cast<uint16_t>(constant);
+            }
+        }
+    }
+    c.y_offset = (range == yuv_range_t::limited) ? 16 : 0;
+
+    // U = (B - Y) / (2 * (1 - kb)), V = (R - Y) / (2 * (1 - kr)), G weight makes the sum zero
+    const auto fixed = [](double value) { return static_cast<int16_t>((value < 0.0) ? (value * 16384.0 - 0.5) : (value * 16384.0 + 0.5)); };
+
+    c.u_r = fixed(-kr / (2.0 * (1.0 - kb)) * uv_scale);
+    c.u_b = fixed(0.5 * uv_scale);
+    c.u_g = static_cast<int16_t>(-(c.u_r + c.u_b));
+
+    c.v_r = fixed(0.5 * uv_scale);
+    c.v_b = fixed(-kb / (2.0 * (1.0 - kr)) * uv_scale);
+    c.v_g = static_cast<int16_t>(-(c.v_r + c.v_b));
+
+    return c;
+}
+
+// All 4 (matrix, range) sets, computed once (by the search above) on first call
+const yuv_coefficients_t& get_yuv_coefficients(yuv_matrix_t matrix, yuv_range_t range)
+{
+    static const yuv_coefficients_t coefficients[2][2] =
+    {
+        { make_yuv_coefficients(yuv_matrix_t::bt601, yuv_range_t::limited), make_yuv_coefficients(yuv_matrix_t::bt601, yuv_range_t::full) },
+        { make_yuv_coefficients(yuv_matrix_t::bt709, yuv_range_t::limited), make_yuv_coefficients(yuv_matrix_t::bt709, yuv_range_t::full) },
+    };
+
+    return coefficients[static_cast<size_t>(matrix)][static_cast<size_t>(range)];
+}
+
+// Y of one pixel (the same arithmetic, as AVX2 kernel)
+static inline uint8_t rgb_to_y(const yuv_coefficients_t& c, int r, int g, int b)
+{
+    return static_cast<uint8_t>(((c.y_r * r + (c.y_g1 + c.y_g2) * g + c.y_b * b + c.y_rounding) >> 8) + c.y_offset);
+}
+
+// U or V from sums of 2x2 block channels (the same arithmetic, as AVX2 kernel)
+static inline uint8_t rgb_sums_to_chroma(int16_t cr, int16_t cg, int16_t cb, int r4, int g4, int b4)
+{
+    const int value = (cr * r4 + cg * g4 + cb * b4 + (128 << 16) + (1 << 15)) >> 16;
+    return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+}
+
+/*
+    Converts columns `[x_begin, width)` of rows `2 * cy` and `2 * cy + 1`
+    (the second is `row0` again, if there is no such row), `x_begin` is even.
+    With `INTERLEAVED_UV` (NV12) `u` is UV plane row, and `v` is not used.
+*/
+template<bool INTERLEAVED_UV>
+void copy_rgba_to_yuv420__raw_ptr__rows(
+    const uint8_t* row0, const uint8_t* row1, uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v,
+    size_t x_begin, size_t width, const yuv_coefficients_t& c)
+{
+    for(size_t x = x_begin; x < width; x += 2)
+    {
+        const size_t x1 = std::min(x + 1, width - 1); // Odd last column: the same pixel twice
+
+        const uint8_t* p[4] = { row0 + (x * 4), row0 + (x1 * 4), row1 + (x * 4), row1 + (x1 * 4) };
+
+        y0[x] = rgb_to_y(c, p[0][0], p[0][1], p[0][2]);
+        if(x1 != x)            { y0[x1] = rgb_to_y(c, p[1][0], p[1][1], p[1][2]); }
+        if(y1 != nullptr)
+        {
+            y1[x] = rgb_to_y(c, p[2][0], p[2][1], p[2][2]);
+            if(x1 != x)        { y1[x1] = rgb_to_y(c, p[3][0], p[3][1], p[3][2]); }
+        }
+
+        const int r4 = p[0][0] + p[1][0] + p[2][0] + p[3][0];
+        const int g4 = p[0][1] + p[1][1] + p[2][1] + p[3][1];
+        const int b4 = p[0][2] + p[1][2] + p[2][2] + p[3][2];
+
+        const uint8_t cu = rgb_sums_to_chroma(c.u_r, c.u_g, c.u_b, r4, g4, b4);
+        const uint8_t cv = rgb_sums_to_chroma(c.v_r, c.v_g, c.v_b, r4, g4, b4);
+        if(INTERLEAVED_UV)
+        {
+            u[x + 0] = cu;
+            u[x + 1] = cv;
+        }
+        else
+        {
+            u[x / 2] = cu;
+            v[x / 2] = cv;
+        }
+    }
+}
+
+// Chroma planes and layout of `copy_rgba_to_yuv420__*()`
+struct yuv420_planes_t
+{
+    uint8_t*  y;
+    ptrdiff_t y_pitch;
+    uint8_t*  u;        // I420: U plane, NV12: UV plane
+    ptrdiff_t u_pitch;
+    uint8_t*  v;        // I420: V plane, NV12: not used
+    ptrdiff_t v_pitch;
+};
+
+template<bool INTERLEAVED_UV>
+void copy_rgba_to_yuv420__raw_ptr(
+    const uint8_t* rgba, ptrdiff_t rgba_pitch, const yuv420_planes_t& planes,
+    size_t width, size_t height, yuv_matrix_t matrix, yuv_range_t range)
+{
+    const yuv_coefficients_t& c = get_yuv_coefficients(matrix, range);
+
+    for(size_t cy = 0; 2 * cy < height; ++cy)
+    {
+        const bool     has_row1 = (2 * cy + 1) < height;
+        const uint8_t* row0     = rgba + (static_cast<ptrdiff_t>(2 * cy) * rgba_pitch);
+        const uint8_t* row1     = has_row1 ? (row0 + rgba_pitch) : row0;
+        uint8_t*       y0       = planes.y + (static_cast<ptrdiff_t>(2 * cy) * planes.y_pitch);
+        uint8_t*       y1       = has_row1 ? (y0 + planes.y_pitch) : nullptr;
+
+        copy_rgba_to_yuv420__raw_ptr__rows<INTERLEAVED_UV>(row0, row1, y0, y1,
+            planes.u + (static_cast<ptrdiff_t>(cy) * planes.u_pitch),
+            INTERLEAVED_UV ? nullptr : (planes.v + (static_cast<ptrdiff_t>(cy) * planes.v_pitch)),
+            0, width, c);
+    }
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+/*
+    Blocks of 16 x 2 pixels (the same loads as 2 rows of 16-pixel kernels):
+
+      - Y: each 8 pixels are shuffled into (R, G, B, G) bytes and multiplied
+        by `_mm256_maddubs_epi16()`, `_mm256_hadd_epi16()` sums the pairs (the
+        sum can exceed int16, so the rest is unsigned: wrapping add, logical
+        shift). Lanes of 4 pixels are interleaved by `hadd`/`packus`, dword
+        permute restores order: 16 bytes of each row.
+      - U, V: 2x2 sums in 16 bits (as in `downscale_2x2_16pixels__avx2()`),
+        `_mm256_madd_epi16()` + `_mm256_hadd_epi32()` give 32-bit U and V of 8
+        blocks, packed into 8 + 8 bytes.
+
+    Remaining columns (less than 16) and odd last row - by scalar code, with
+    the same arithmetic (the results are identical).
+*/
+template<bool INTERLEAVED_UV>
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_yuv420__avx2(
+    const uint8_t* rgba, ptrdiff_t rgba_pitch, const yuv420_planes_t& planes,
+    size_t width, size_t height, yuv_matrix_t matrix, yuv_range_t range)
+{
+    const yuv_coefficients_t& c = get_yuv_coefficients(matrix, range);
+
+    // Y: (R, G, B, G) of each pixel
+    const __m256i y_shuffle = _mm256_setr_epi8(
+        0, 1, 2, 1,  4, 5, 6, 5,  8, 9, 10, 9,  12, 13, 14, 13,
+        0, 1, 2, 1,  4, 5, 6, 5,  8, 9, 10, 9,  12, 13, 14, 13);
+    const __m256i y_weights = _mm256_set1_epi32(static_cast<int>(
+        (static_cast<uint32_t>(static_cast<uint8_t>(c.y_r ))      ) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(c.y_g1)) <<  8) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(c.y_b )) << 16) |
+        (static_cast<uint32_t>(static_cast<uint8_t>(c.y_g2)) << 24)));
+    const __m256i y_rounding = _mm256_set1_epi16(static_cast<int16_t>(c.y_rounding));
+    const __m256i y_offset   = _mm256_set1_epi16(static_cast<int16_t>(c.y_offset));
+    const __m256i y_order    = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    // U, V: 16-bit channels (R, G, B, A) of 2x2 sums
+    const __m256i u_weights = _mm256_setr_epi16(c.u_r, c.u_g, c.u_b, 0, c.u_r, c.u_g, c.u_b, 0, c.u_r, c.u_g, c.u_b, 0, c.u_r, c.u_g, c.u_b, 0);
+    const __m256i v_weights = _mm256_setr_epi16(c.v_r, c.v_g, c.v_b, 0, c.v_r, c.v_g, c.v_b, 0, c.v_r, c.v_g, c.v_b, 0, c.v_r, c.v_g, c.v_b, 0);
+    const __m256i uv_rounding = _mm256_set1_epi32((128 << 16) + (1 << 15));
+    const __m256i uv_order    = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    const __m256i zero        = _mm256_setzero_si256();
+
+    const size_t num_blocks = width / 16;
+
+    for(size_t cy = 0; 2 * cy < height; ++cy)
+    {
+        const bool     has_row1 = (2 * cy + 1) < height;
+        const uint8_t* row0     = rgba + (static_cast<ptrdiff_t>(2 * cy) * rgba_pitch);
+        const uint8_t* row1     = has_row1 ? (row0 + rgba_pitch) : row0;
+        uint8_t*       y0       = planes.y + (static_cast<ptrdiff_t>(2 * cy) * planes.y_pitch);
+        uint8_t*       y1       = has_row1 ? (y0 + planes.y_pitch) : nullptr;
+        uint8_t*       u        = planes.u + (static_cast<ptrdiff_t>(cy) * planes.u_pitch);
+        uint8_t*       v        = INTERLEAVED_UV ? nullptr : (planes.v + (static_cast<ptrdiff_t>(cy) * planes.v_pitch));
+
+        if(has_row1 == false)
+        {
+            copy_rgba_to_yuv420__raw_ptr__rows<INTERLEAVED_UV>(row0, row1, y0, y1, u, v, 0, width, c);
+            continue;
+        }
+
+        for(size_t i = 0; i < num_blocks; ++i)
+        {
+            // Load 16 RGBA pixels of each row
+            const __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + (i * 64)     ));
+            const __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + (i * 64) + 32));
+            const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + (i * 64)     ));
+            const __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + (i * 64) + 32));
+
+            // -----------------------------------------------------------------
+            // Y: 16 + 16 bytes
+
+            const __m256i ya = _mm256_hadd_epi16(_mm256_maddubs_epi16(_mm256_shuffle_epi8(a0, y_shuffle), y_weights),
+                                                 _mm256_maddubs_epi16(_mm256_shuffle_epi8(a1, y_shuffle), y_weights));
+            const __m256i yb = _mm256_hadd_epi16(_mm256_maddubs_epi16(_mm256_shuffle_epi8(b0, y_shuffle), y_weights),
+                                                 _mm256_maddubs_epi16(_mm256_shuffle_epi8(b1, y_shuffle), y_weights));
+
+            const __m256i ya_8 = _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(ya, y_rounding), 8), y_offset);
+            const __m256i yb_8 = _mm256_add_epi16(_mm256_srli_epi16(_mm256_add_epi16(yb, y_rounding), 8), y_offset);
+
+            // Dwords: [a 0-3, a 8-11, b 0-3, b 8-11 | a 4-7, a 12-15, b 4-7, b 12-15] --> [a 0-15 | b 0-15]
+            const __m256i y_bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ya_8, yb_8), y_order);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + (i * 16)), _mm256_castsi256_si128(y_bytes));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + (i * 16)), _mm256_extracti128_si256(y_bytes, 1));
+
+            // -----------------------------------------------------------------
+            // U, V: 8 + 8 bytes
+
+            __m256i sums[2]; // 2x2 sums of blocks 0,1 | 2,3 and 4,5 | 6,7 (low | high lane)
+            {
+                const __m256i lo0 = _mm256_add_epi16(_mm256_unpacklo_epi8(a0, zero), _mm256_unpacklo_epi8(b0, zero));
+                const __m256i hi0 = _mm256_add_epi16(_mm256_unpackhi_epi8(a0, zero), _mm256_unpackhi_epi8(b0, zero));
+                const __m256i lo1 = _mm256_add_epi16(_mm256_unpacklo_epi8(a1, zero), _mm256_unpacklo_epi8(b1, zero));
+                const __m256i hi1 = _mm256_add_epi16(_mm256_unpackhi_epi8(a1, zero), _mm256_unpackhi_epi8(b1, zero));
+
+                sums[0] = _mm256_add_epi16(_mm256_unpacklo_epi64(lo0, hi0), _mm256_unpackhi_epi64(lo0, hi0));
+                sums[1] = _mm256_add_epi16(_mm256_unpacklo_epi64(lo1, hi1), _mm256_unpackhi_epi64(lo1, hi1));
+            }
+
+            const __m256i s01_45 = _mm256_permute2x128_si256(sums[0], sums[1], 0x20); // Blocks 0,1 | 4,5
+            const __m256i s23_67 = _mm256_permute2x128_si256(sums[0], sums[1], 0x31); // Blocks 2,3 | 6,7
+
+            const __m256i u32 = _mm256_hadd_epi32(_mm256_madd_epi16(s01_45, u_weights), _mm256_madd_epi16(s23_67, u_weights)); // 0-3 | 4-7
+            const __m256i v32 = _mm256_hadd_epi32(_mm256_madd_epi16(s01_45, v_weights), _mm256_madd_epi16(s23_67, v_weights));
+
+            const __m256i u16_v16 = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(u32, uv_rounding), 16),
+                                                       _mm256_srai_epi32(_mm256_add_epi32(v32, uv_rounding), 16)); // U 0-3, V 0-3 | U 4-7, V 4-7
+
+            // Dwords: [U 0-3, V 0-3, 0, 0 | U 4-7, V 4-7, 0, 0] --> [U 0-7, V 0-7 | 0]
+            const __m128i uv_bytes = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(_mm256_packus_epi16(u16_v16, zero), uv_order));
+
+            if(INTERLEAVED_UV)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(u + (i * 16)), _mm_unpacklo_epi8(uv_bytes, _mm_srli_si128(uv_bytes, 8)));
+            }
+            else
+            {
+                _mm_storeu_si64(u + (i * 8), uv_bytes);
+                _mm_storeu_si64(v + (i * 8), _mm_srli_si128(uv_bytes, 8));
+            }
+        }
+
+        copy_rgba_to_yuv420__raw_ptr__rows<INTERLEAVED_UV>(row0, row1, y0, y1, u, v, num_blocks * 16, width, c);
+    }
+}
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+using copy_rgba_to_yuv420_func_t = void (*) (const uint8_t*, ptrdiff_t, const yuv420_planes_t&, size_t, size_t, yuv_matrix_t, yuv_range_t);
+
+template<bool INTERLEAVED_UV>
+copy_rgba_to_yuv420_func_t resolve_copy_rgba_to_yuv420()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        return copy_rgba_to_yuv420__avx2<INTERLEAVED_UV>;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_yuv420__raw_ptr<INTERLEAVED_UV>;
+}
+
+// Resolved once, at startup (during static initialization)
+static const copy_rgba_to_yuv420_func_t g_copy_rgba_to_i420_impl = resolve_copy_rgba_to_yuv420<false>();
+static const copy_rgba_to_yuv420_func_t g_copy_rgba_to_nv12_impl = resolve_copy_rgba_to_yuv420<true>();
+
+/*
+    Converts `width` x `height` RGBA image into I420 (planar Y, U, V; U and V
+    are `(width + 1) / 2` x `(height + 1) / 2`) or NV12 (Y and interleaved
+    UV plane), for encoders, without intermediate RGB frame.
+*/
+void copy_rgba_to_i420(
+    const uint8_t* rgba, ptrdiff_t rgba_pitch,
+    uint8_t* y, ptrdiff_t y_pitch, uint8_t* u, ptrdiff_t u_pitch, uint8_t* v, ptrdiff_t v_pitch,
+    size_t width, size_t height, yuv_matrix_t matrix, yuv_range_t range)
+{
+    const yuv420_planes_t planes{y, y_pitch, u, u_pitch, v, v_pitch};
+    g_copy_rgba_to_i420_impl(rgba, rgba_pitch, planes, width, height, matrix, range);
+}
+
+void copy_rgba_to_nv12(
+    const uint8_t* rgba, ptrdiff_t rgba_pitch,
+    uint8_t* y, ptrdiff_t y_pitch, uint8_t* uv, ptrdiff_t uv_pitch,
+    size_t width, size_t height, yuv_matrix_t matrix, yuv_range_t range)
+{
+    const yuv420_planes_t planes{y, y_pitch, uv, uv_pitch, nullptr, 0};
+    g_copy_rgba_to_nv12_impl(rgba, rgba_pitch, planes, width, height, matrix, range);
+}
+
+// -----------------------------------------------------------------------------
+// RGBA to planar RGB (CHW: all R, then all G, then all B; alpha is dropped)
+//
+// Input of ML inference: `uint8` planes, or normalized `float` tensor, written
+// directly (without intermediate RGB frame and a separate split/normalize pass).
+// For NCHW batch of N images, the image `n` is at `tensor + (n * 3 * num_pixels)`.
+
+// Per-channel (R, G, B) normalization: `out = (value - mean) * scale`
+struct channel_normalization_t
+{
+    float mean [3];
+    float scale[3];
+};
+
+// Mean and std. deviation of ImageNet, the most common preprocessing of vision models
+static const channel_normalization_t IMAGENET_NORMALIZATION =
+{
+    {123.675f, 116.28f, 103.53f},
+    {1.0f / 58.395f, 1.0f / 57.12f, 1.0f / 57.375f},
+};
+
+// Plane `c` starts at `planes + (c * num_pixels)`
+void copy_rgba_to_planar__raw_ptr(const uint8_t* rgba, uint8_t* planes, size_t num_pixels)
+{
+    uint8_t* r = planes;
+    uint8_t* g = planes + num_pixels;
+    uint8_t* b = planes + (num_pixels * 2);
+
+    for(size_t i = 0; i < num_pixels; ++i)
+    {
+        r[i] = rgba[(i * 4) + 0];
+        g[i] = rgba[(i * 4) + 1];
+        b[i] = rgba[(i * 4) + 2];
+    }
+}
+
+/*
+    NOTE: `out = value * scale + bias`, where `bias = -mean * scale` - one
+    multiply-add, as in AVX2 kernel (which uses FMA, so the results may differ
+    in the last bit). Planes are `plane_stride` floats apart (to convert a part
+    of the image, e.g. a tail).
+*/
+void copy_rgba_to_planar_float__raw_ptr__strided(const uint8_t* rgba, float* tensor, size_t plane_stride, size_t num_pixels, const channel_normalization_t& normalization)
+{
+    for(size_t c = 0; c < 3; ++c)
+    {
+        const float scale = normalization.scale[c];
+        const float bias  = -normalization.mean[c] * scale;
+        float*      plane = tensor + (c * plane_stride);
+
+        for(size_t i = 0; i < num_pixels; ++i)
+        {
+            plane[i] = static_cast<float>(rgba[(i * 4) + c]) * scale + bias;
+        }
+    }
+}
+
+void copy_rgba_to_planar_float__raw_ptr(const uint8_t* rgba, float* tensor, size_t num_pixels, const channel_normalization_t& normalization)
+{
+    copy_rgba_to_planar_float__raw_ptr__strided(rgba, tensor, num_pixels, num_pixels, normalization);
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+/*
+    Deinterleaves 8 RGBA pixels into 8-byte groups of each channel:
+
+      - Shuffle within lanes: [R 0-3, G 0-3, B 0-3, A 0-3 | R 4-7, G 4-7, B 4-7, A 4-7]
+      - Dword permute: [R 0-7, G 0-7 | B 0-7, A 0-7]
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline __m256i deinterleave_8rgba_pixels__avx2(const __m256i& v)
+{
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 4, 8, 12,  1, 5, 9, 13,  2, 6, 10, 14,  3, 7, 11, 15,
+        0, 4, 8, 12,  1, 5, 9, 13,  2, 6, 10, 14,  3, 7, 11, 15);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    return _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, shuffle), order);
+}
+
+// 16 pixels per iteration: 16-byte stores to each plane
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgba_to_planar__avx2(const uint8_t* rgba, uint8_t* planes, size_t num_pixels)
+{
+    uint8_t* r = planes;
+    uint8_t* g = planes + num_pixels;
+    uint8_t* b = planes + (num_pixels * 2);
+
+    const size_t num_blocks = num_pixels / 16;
+    for(size_t i = 0; i < num_blocks; ++i)
+    {
+        const __m256i v0 = deinterleave_8rgba_pixels__avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + (i * 64)     )));
+        const __m256i v1 = deinterleave_8rgba_pixels__avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + (i * 64) + 32)));
+
+        const __m128i rg0 = _mm256_castsi256_si128(v0), ba0 = _mm256_extracti128_si256(v0, 1);
+        const __m128i rg1 = _mm256_castsi256_si128(v1), ba1 = _mm256_extracti128_si256(v1, 1);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + (i * 16)), _mm_unpacklo_epi64(rg0, rg1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(g + (i * 16)), _mm_unpackhi_epi64(rg0, rg1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b + (i * 16)), _mm_unpacklo_epi64(ba0, ba1));
+    }
+
+    for(size_t i = num_blocks * 16; i < num_pixels; ++i)
+    {
+        r[i] = rgba[(i * 4) + 0];
+        g[i] = rgba[(i * 4) + 1];
+        b[i] = rgba[(i * 4) + 2];
+    }
+}
+
+/*
+    Single pass, 8 pixels per iteration: deinterleave, widen 8 bytes of each
+    channel by `_mm256_cvtepu8_epi32()`, convert to float, and normalize by one
+    FMA. Each plane gets a 32-byte store.
+
+    NOTE: best for tensors larger than cache, but in cache it's ~2x slower, than
+    one plane at a time: loads and 3 store streams, `num_pixels * 4` bytes apart,
+    often share L1 sets (and 4K-alias, as for 224x224), see `__chunked`.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2_FMA
+void copy_rgba_to_planar_float__avx2_fma__single_pass(const uint8_t* rgba, float* tensor, size_t num_pixels, const channel_normalization_t& normalization)
+{
+    float* planes[3] = { tensor, tensor + num_pixels, tensor + (num_pixels * 2) };
+
+    __m256 scale[3];
+    __m256 bias [3];
+    for(size_t c = 0; c < 3; ++c)
+    {
+        scale[c] = _mm256_set1_ps(normalization.scale[c]);
+        bias [c] = _mm256_set1_ps(-normalization.mean[c] * normalization.scale[c]);
+    }
+
+    const size_t num_blocks = num_pixels / 8;
+    for(size_t i = 0; i < num_blocks; ++i)
+    {
+        const __m256i v  = deinterleave_8rgba_pixels__avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + (i * 32))));
+        const __m128i rg = _mm256_castsi256_si128(v);
+        const __m128i ba = _mm256_extracti128_si256(v, 1);
+
+        const __m256 r = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(rg));
+        const __m256 g = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(rg, 8)));
+        const __m256 b = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(ba));
+
+        _mm256_storeu_ps(planes[0] + (i * 8), _mm256_fmadd_ps(r, scale[0], bias[0]));
+        _mm256_storeu_ps(planes[1] + (i * 8), _mm256_fmadd_ps(g, scale[1], bias[1]));
+        _mm256_storeu_ps(planes[2] + (i * 8), _mm256_fmadd_ps(b, scale[2], bias[2]));
+    }
+
+    const size_t num_converted = num_blocks * 8;
+    copy_rgba_to_planar_float__raw_ptr__strided(rgba + (num_converted * 4), tensor + num_converted, num_pixels, num_pixels - num_converted, normalization);
+}
+
+/*
+    Chunks of 1024 pixels: deinterleave into `uint8` planes on stack (by
+    `copy_rgba_to_planar__avx2()`), then one output plane at a time: widen 8
+    bytes by `_mm256_cvtepu8_epi32()` (from L1), convert, FMA, store.
+
+    Input is still read from memory once, but the output is a single store
+    stream at a time.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2_FMA
+void copy_rgba_to_planar_float__avx2_fma__chunked(const uint8_t* rgba, float* tensor, size_t num_pixels, const channel_normalization_t& normalization)
+{
+    static constexpr size_t CHUNK_PIXELS = 1024;
+
+    __m256 scale[3];
+    __m256 bias [3];
+    for(size_t c = 0; c < 3; ++c)
+    {
+        scale[c] = _mm256_set1_ps(normalization.scale[c]);
+        bias [c] = _mm256_set1_ps(-normalization.mean[c] * normalization.scale[c]);
+    }
+
+    alignas(32) uint8_t planar[CHUNK_PIXELS * 3];
+
+    for(size_t begin = 0; begin < num_pixels; begin += CHUNK_PIXELS)
+    {
+        const size_t num_chunk_pixels = std::min(CHUNK_PIXELS, num_pixels - begin);
+        const size_t num_blocks       = num_chunk_pixels / 8;
+
+        copy_rgba_to_planar__avx2(rgba + (begin * 4), planar, num_chunk_pixels);
+
+        for(size_t c = 0; c < 3; ++c)
+        {
+            const uint8_t* src = planar + (c * num_chunk_pixels);
+            float*         dst = tensor + (c * num_pixels) + begin;
+
+            for(size_t i = 0; i < num_blocks; ++i)
+            {
+                const __m256 x = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + (i * 8)))));
+                _mm256_storeu_ps(dst + (i * 8), _mm256_fmadd_ps(x, scale[c], bias[c]));
+            }
+        }
+
+        const size_t num_converted = num_blocks * 8;
+        copy_rgba_to_planar_float__raw_ptr__strided(rgba + ((begin + num_converted) * 4), tensor + begin + num_converted, num_pixels,
+                                                    num_chunk_pixels - num_converted, normalization);
+    }
+}
+
+// Tensor (with its output) fits into cache - chunked, otherwise - single pass
+COPY_RGBA_TO_RGB__TARGET_AVX2_FMA
+void copy_rgba_to_planar_float__avx2_fma(const uint8_t* rgba, float* tensor, size_t num_pixels, const channel_normalization_t& normalization)
+{
+    if(num_pixels * (4 + 12) <= g_copy_rgba_to_rgb_streaming_threshold)
+    {
+        copy_rgba_to_planar_float__avx2_fma__chunked(rgba, tensor, num_pixels, normalization);
+    }
+    else
+    {
+        copy_rgba_to_planar_float__avx2_fma__single_pass(rgba, tensor, num_pixels, normalization);
+    }
+}
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+using copy_rgba_to_planar_func_t       = void (*) (const uint8_t*, uint8_t*, size_t);
+using copy_rgba_to_planar_float_func_t = void (*) (const uint8_t*, float*, size_t, const channel_normalization_t&);
+
+copy_rgba_to_planar_func_t resolve_copy_rgba_to_planar()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        return copy_rgba_to_planar__avx2;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_planar__raw_ptr;
+}
+
+copy_rgba_to_planar_float_func_t resolve_copy_rgba_to_planar_float()
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2 && get_cpu_features().fma)
+    {
+        return copy_rgba_to_planar_float__avx2_fma;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    return copy_rgba_to_planar_float__raw_ptr;
+}
+
+// Resolved once, at startup (during static initialization)
+static const copy_rgba_to_planar_func_t       g_copy_rgba_to_planar_impl       = resolve_copy_rgba_to_planar();
+static const copy_rgba_to_planar_float_func_t g_copy_rgba_to_planar_float_impl = resolve_copy_rgba_to_planar_float();
+
+// Converts RGBA pixels into `uint8` R, G and B planes (each `num_pixels` long, one after another)
+void copy_rgba_to_planar(const uint8_t* rgba, uint8_t* planes, size_t num_pixels)
+{
+    g_copy_rgba_to_planar_impl(rgba, planes, num_pixels);
+}
+
+// Converts RGBA pixels into normalized `float` CHW tensor (3 planes of `num_pixels`)
+void copy_rgba_to_planar_float(const uint8_t* rgba, float* tensor, size_t num_pixels, const channel_normalization_t& normalization)
+{
+    g_copy_rgba_to_planar_float_impl(rgba, tensor, num_pixels, normalization);
+}
+
+// -----------------------------------------------------------------------------
+// In-place compaction: RGBA to RGB in the same buffer
+//
+// Output pixel `i` occupies bytes [3i, 3i + 3), input pixel `i` - [4i, 4i + 4),
+// so output never overtakes the input, and forward conversion never
+// overwrites bytes, which are not read yet.
+
+void rgba_to_rgb_inplace__raw_ptr(uint8_t* buf, size_t num_pixels)
+{
+    const uint8_t* rgba = buf;
+    uint8_t*       rgb  = buf;
+
+    size_t i = 0;
+    for(; i < num_pixels; ++i)
+    {
+        // Each byte is read before it can be overwritten: 3i + c < 4i + c + 1
+        rgb[0] = rgba[0]; // Copy R
+        rgb[1] = rgba[1]; // Copy G
+        rgb[2] = rgba[2]; // Copy B
+        rgba += 4;
+        rgb  += 3;
+    }
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+
+/*
+    Same as `copy_rgba_to_rgb__avx2__32pixels__full_stores()`, but `rgba` and
+    `rgb` are the same buffer.
+
+    Why it's safe for aliasing - block `k` (32 pixels):
+      - reads  [128k, 128k + 128)
+      - writes [ 96k,  96k +  96) - exactly, no overlapping junk stores
+    1. All 4 loads of the block are issued before any of its stores (and since
+       the pointers alias, neither compiler nor CPU may reorder them).
+    2. The highest written byte `96k + 95` is below `128(k + 1)`, the lowest
+       byte of the next (not yet read) block.
+    Remaining pixels are converted by the scalar loop, which is safe as well
+    (see `rgba_to_rgb_inplace__raw_ptr()`).
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void rgba_to_rgb_inplace__avx2__32pixels(uint8_t* buf, size_t num_pixels)
+{
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<rgba_order_t, rgb_order_t>();
+
+    const uint8_t* rgba = buf;
+    uint8_t*       rgb  = buf;
+
+    // Reusable
+    __m256i v[4];
+    __m256i out[3];
+
+    const size_t num_32pixel_blocks = num_pixels / 32; //  Process 32 pixels per iteration
+    for(size_t i = 0; i < num_32pixel_blocks; ++i)
+    {
+        // Load the whole block first: some of these bytes are overwritten below
+        v[0] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba     ));
+        v[1] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 32));
+        v[2] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 64));
+        v[3] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 96));
+
+        v[0] = _mm256_shuffle_epi8(v[0], shuffle_mask);
+        v[1] = _mm256_shuffle_epi8(v[1], shuffle_mask);
+        v[2] = _mm256_shuffle_epi8(v[2], shuffle_mask);
+        v[3] = _mm256_shuffle_epi8(v[3], shuffle_mask);
+
+        pack_4x_shuffled_into_3x256__avx2(v, out);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb     ), out[0]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 32), out[1]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 64), out[2]);
+
+        rgba += 128; // Move forward by 32 pixels in RGBA (32 * 4 = 128)
+        rgb  +=  96; // Move forward by 32 pixels in RGB  (32 * 3 =  96)
+    }
+
+    // Handle the remaining pixels (fallback to scalar loop)
+    for(size_t i = num_32pixel_blocks * 32; i < num_pixels; ++i)
+    {
+        rgb[0] = rgba[0]; // Copy R
+        rgb[1] = rgba[1]; // Copy G
+        rgb[2] = rgba[2]; // Copy B
+        rgba += 4;
+        rgb  += 3;
+    }
+}
+
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+/*
+    Converts `num_pixels` RGBA pixels into RGB pixels in the same buffer: after
+    the call, first `num_pixels * 3` bytes of `buf` hold RGB pixels (the rest -
+    leftovers of the input).
+*/
+void rgba_to_rgb_inplace(uint8_t* buf, size_t num_pixels)
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        rgba_to_rgb_inplace__avx2__32pixels(buf, num_pixels);
+        return;
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    rgba_to_rgb_inplace__raw_ptr(buf, num_pixels);
+}
+
+// -----------------------------------------------------------------------------
+// Alpha compositing: RGBA over solid background color, to RGB
+//
+//   rgb = (a * src + (255 - a) * bg) / 255 (rounded to nearest)
+
+// Exact `round(x / 255)` for `x` in [0, 255 * 255], without division
+static inline uint8_t div255_round(uint32_t x)
+{
+    x += 128;
+    return static_cast<uint8_t>( (x + (x >> 8)) >> 8 );
+}
+
+void blend_rgba_over_rgb__raw_ptr(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels, uint8_t bg_r, uint8_t bg_g, uint8_t bg_b)
+{
+    size_t i = 0;
+    for(; i < num_pixels; ++i)
+    {
+        const uint32_t a     = rgba[3];
+        const uint32_t inv_a = 255 - a;
+        rgb[0] = div255_round( (a * rgba[0]) + (inv_a * bg_r) ); // Blend R
+        rgb[1] = div255_round( (a * rgba[1]) + (inv_a * bg_g) ); // Blend G
+        rgb[2] = div255_round( (a * rgba[2]) + (inv_a * bg_b) ); // Blend B
+        rgba += 4;
+        rgb  += 3;
+    }
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+
+/*
+    Blends 8 RGBA pixels over background, in 16-bit lanes. Returns them in the
+    same [R,G,B,x] layout (alpha byte is junk), so the result goes through
+    the same shuffle and stores, as in `copy_rgba_to_rgb__avx2__8pixels()`.
+
+    `bg_16` - background as [R,G,B,0] 16-bit words, repeated 4 times.
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline __m256i blend_8pixels_over_background__avx2(const __m256i& v, const __m256i& bg_16)
+{
+    const __m256i zero    = _mm256_setzero_si256();
+    const __m256i v_255   = _mm256_set1_epi16(255);
+    const __m256i v_128   = _mm256_set1_epi16(128);
+
+    // Widen to 16 bits: 2 pixels per 128-bit lane in each
+    __m256i lo = _mm256_unpacklo_epi8(v, zero);
+    __m256i hi = _mm256_unpackhi_epi8(v, zero);
+
+    // Broadcast alpha (word 3 of each pixel) to all 4 words of the pixel
+    const __m256i a_lo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(lo, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+    const __m256i a_hi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(hi, _MM_SHUFFLE(3,3,3,3)), _MM_SHUFFLE(3,3,3,3));
+
+    // a * src + (255 - a) * bg  <= 255 * 255, fits into unsigned 16 bits
+    lo = _mm256_add_epi16(_mm256_mullo_epi16(lo, a_lo), _mm256_mullo_epi16(bg_16, _mm256_sub_epi16(v_255, a_lo)));
+    hi = _mm256_add_epi16(_mm256_mullo_epi16(hi, a_hi), _mm256_mullo_epi16(bg_16, _mm256_sub_epi16(v_255, a_hi)));
+
+    // Exact rounded division by 255: t = x + 128; (t + (t >> 8)) >> 8
+    lo = _mm256_add_epi16(lo, v_128);
+    hi = _mm256_add_epi16(hi, v_128);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+    // Narrow back to 8 bits (restores original pixel order)
+    return _mm256_packus_epi16(lo, hi);
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void blend_rgba_over_rgb__avx2__8pixels(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels, uint8_t bg_r, uint8_t bg_g, uint8_t bg_b)
+{
+    // Shuffle mask to extract RGB bytes while discarding the Alpha byte
+    const __m256i shuffle_mask = make_shuffle_mask_4ch_to_3ch__avx2<rgba_order_t, rgb_order_t>();
+
+    const __m256i bg_16 = _mm256_setr_epi16(
+        bg_r, bg_g, bg_b, 0,  bg_r, bg_g, bg_b, 0,
+        bg_r, bg_g, bg_b, 0,  bg_r, bg_g, bg_b, 0
+    );
+
+    // Reusable
+    __m256i v;
+    __m128i part_128;
+    size_t i = 0;
+
+    const size_t num_8pixel_blocks = num_pixels / 8; //  Process 8 pixels per iteration
+    if(num_8pixel_blocks > 0)
+    {
+        // Run the main loop for all but the last block (overlapping stores, 28 bytes)
+        for(; i < (num_8pixel_blocks - 1); ++i)
+        {
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba));
+            v = blend_8pixels_over_background__avx2(v, bg_16);
+            v = _mm256_shuffle_epi8(v, shuffle_mask);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb     ), _mm256_extracti128_si256(v, 0)); // 16 bytes (useful - first 12)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + 12), _mm256_extracti128_si256(v, 1)); // 16 bytes (useful - first 12)
+
+            rgba += 32; // Move forward by 8 pixels in RGBA (8 * 4 = 32)
+            rgb  += 24; // Move forward by 8 pixels in RGB  (8 * 3 = 24)
+        }
+
+        // Last block - precise (24 bytes)
+        {
+            v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba));
+            v = blend_8pixels_over_background__avx2(v, bg_16);
+            v = _mm256_shuffle_epi8(v, shuffle_mask);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb), _mm256_extracti128_si256(v, 0)); // 16 bytes (useful - first 12)
+
+            part_128 = _mm256_extracti128_si256(v, 1);
+            _mm_storeu_si64(rgb + 12, part_128); // 8 bytes
+            part_128 = _mm_srli_si128(part_128, 8);
+            _mm_storeu_si32(rgb + 20, part_128); // 4 bytes
+
+            rgba += 32; // Move forward by 8 pixels in RGBA (8 * 4 = 32)
+            rgb  += 24; // Move forward by 8 pixels in RGB  (8 * 3 = 24)
+        }
+    }
+
+    // Handle the remaining pixels (fallback to scalar loop)
+    i = num_8pixel_blocks * 8; // Number of processed pixels
+    blend_rgba_over_rgb__raw_ptr(rgba, rgb, num_pixels - i, bg_r, bg_g, bg_b);
+}
+
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+// -----------------------------------------------------------------------------
+// Reverse direction: RGB to RGBA (with constant alpha)
+
+void copy_rgb_to_rgba__raw_ptr(const uint8_t* rgb, uint8_t* rgba, size_t num_pixels, uint8_t alpha)
+{
+    size_t i = 0;
+    for(; i < num_pixels; ++i)
+    {
+        rgba[0] = rgb[0]; // Copy R
+        rgba[1] = rgb[1]; // Copy G
+        rgba[2] = rgb[2]; // Copy B
+        rgba[3] = alpha;  // Fill A
+        rgb  += 3;
+        rgba += 4;
+    }
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+
+/*
+    Loads 8 RGB pixels (24 bytes) as two halves: 4 pixels into each 128-bit
+    lane, since `_mm256_shuffle_epi8()` can't move bytes across lanes.
+
+    Overlapping (fast) load reads 4 bytes past the 8 pixels:
+
+                          |00 01 02 03 04 05 06 07 08 09 10 11 12 13 14 15|16 17 18 19 20 21 22 23 24 25 26 27|
+        low  lane      -> |RR GG BB|RR GG BB|RR GG BB|RR GG BB|xx xx xx xx|                                   |
+                          +-----------------------------------------------+                                   |
+                                              high lane --> |RR GG BB|RR GG BB|RR GG BB|RR GG BB|xx xx xx xx|
+                                                            +-----------------------------------------------+
+
+    It's safe for all but the last block (next block's pixels are there).
+    Precise load for the last block reads high lane from `rgb + 8` instead,
+    so its pixels start at byte 4 of the lane (see `shuffle_mask_last`).
+*/
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline __m256i load_8rgb_pixels__avx2__overlapping(const uint8_t* rgb)
+{
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb     ));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 12));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static inline __m256i load_8rgb_pixels__avx2__precise(const uint8_t* rgb)
+{
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb    ));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 8));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgb_to_rgba__avx2__8pixels(const uint8_t* rgb, uint8_t* rgba, size_t num_pixels, uint8_t alpha)
+{
+    // Shuffle mask to expand RGB into RGBA, leaving zero in place of alpha
+    const __m256i shuffle_mask = _mm256_set_epi8(
+        -1,11,10,9,  -1,8,7,6,  -1,5,4,3,  -1,2,1,0, // Expand 4 RGB in second half
+        -1,11,10,9,  -1,8,7,6,  -1,5,4,3,  -1,2,1,0  // Expand 4 RGB in first half
+    );
+
+    // Same, but second half is loaded 4 bytes earlier (see `load_8rgb_pixels__avx2__precise()`)
+    const __m256i shuffle_mask_last = _mm256_set_epi8(
+        -1,15,14,13,  -1,12,11,10,  -1,9,8,7,  -1,6,5,4, // Expand 4 RGB in second half
+        -1,11,10, 9,  -1, 8, 7, 6,  -1,5,4,3,  -1,2,1,0  // Expand 4 RGB in first half
+    );
+
+    const __m256i alpha_mask = _mm256_set1_epi32( static_cast<int>(static_cast<uint32_t>(alpha) << 24) );
+
+    // Reusable
+    __m256i v;
+    size_t i = 0;
+
+    const size_t num_8pixel_blocks = num_pixels / 8; //  Process 8 pixels per iteration
+    if(num_8pixel_blocks > 0)
+    {
+        // Run the main loop for all but the last block (overlapping loads)
+        for(; i < (num_8pixel_blocks - 1); ++i)
+        {
+            v = load_8rgb_pixels__avx2__overlapping(rgb);
+            v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle_mask), alpha_mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba), v); // Store exactly 32 bytes
+
+            rgb  += 24; // Move forward by 8 pixels in RGB  (8 * 3 = 24)
+            rgba += 32; // Move forward by 8 pixels in RGBA (8 * 4 = 32)
+        }
+
+        // Last block - precise load, not reading out-of-bounds
+        {
+            v = load_8rgb_pixels__avx2__precise(rgb);
+            v = _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle_mask_last), alpha_mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba), v); // Store exactly 32 bytes
+
+            rgb  += 24; // Move forward by 8 pixels in RGB  (8 * 3 = 24)
+            rgba += 32; // Move forward by 8 pixels in RGBA (8 * 4 = 32)
+        }
+    }
+
+    // Handle the remaining pixels (fallback to scalar loop)
+    i = num_8pixel_blocks * 8; // Number of processed pixels
+    for(; i < num_pixels; ++i)
+    {
+        rgba[0] = rgb[0]; // Copy R
+        rgba[1] = rgb[1]; // Copy G
+        rgba[2] = rgb[2]; // Copy B
+        rgba[3] = alpha;  // Fill A
+        rgb  += 3;
+        rgba += 4;
+    }
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+void copy_rgb_to_rgba__avx2__32pixels(const uint8_t* rgb, uint8_t* rgba, size_t num_pixels, uint8_t alpha)
+{
+    // Shuffle mask to expand RGB into RGBA, leaving zero in place of alpha
+    const __m256i shuffle_mask = _mm256_set_epi8(
+        -1,11,10,9,  -1,8,7,6,  -1,5,4,3,  -1,2,1,0, // Expand 4 RGB in second half
+        -1,11,10,9,  -1,8,7,6,  -1,5,4,3,  -1,2,1,0  // Expand 4 RGB in first half
+    );
+
+    // Same, but second half is loaded 4 bytes earlier (see `load_8rgb_pixels__avx2__precise()`)
+    const __m256i shuffle_mask_last = _mm256_set_epi8(
+        -1,15,14,13,  -1,12,11,10,  -1,9,8,7,  -1,6,5,4, // Expand 4 RGB in second half
+        -1,11,10, 9,  -1, 8, 7, 6,  -1,5,4,3,  -1,2,1,0  // Expand 4 RGB in first half
+    );
+
+    const __m256i alpha_mask = _mm256_set1_epi32( static_cast<int>(static_cast<uint32_t>(alpha) << 24) );
+
+    // Reusable
+    __m256i v[4];
+    size_t i = 0;
+
+    const size_t num_32pixel_blocks = num_pixels / 32; //  Process 32 pixels per iteration
+    if(num_32pixel_blocks > 0)
+    {
+        // Run the main loop for all but the last block (overlapping loads)
+        for(; i < (num_32pixel_blocks - 1); ++i)
+        {
+            v[0] = load_8rgb_pixels__avx2__overlapping(rgb     );
+            v[1] = load_8rgb_pixels__avx2__overlapping(rgb + 24);
+            v[2] = load_8rgb_pixels__avx2__overlapping(rgb + 48);
+            v[3] = load_8rgb_pixels__avx2__overlapping(rgb + 72);
+
+            v[0] = _mm256_or_si256(_mm256_shuffle_epi8(v[0], shuffle_mask), alpha_mask);
+            v[1] = _mm256_or_si256(_mm256_shuffle_epi8(v[1], shuffle_mask), alpha_mask);
+            v[2] = _mm256_or_si256(_mm256_shuffle_epi8(v[2], shuffle_mask), alpha_mask);
+            v[3] = _mm256_or_si256(_mm256_shuffle_epi8(v[3], shuffle_mask), alpha_mask);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba     ), v[0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 32), v[1]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 64), v[2]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 96), v[3]);
+
+            rgb  +=  96; // Move forward by 32 pixels in RGB  (32 * 3 =  96)
+            rgba += 128; // Move forward by 32 pixels in RGBA (32 * 4 = 128)
+        }
+
+        // Last block - only its last 8 pixels need precise load
+        {
+            v[0] = load_8rgb_pixels__avx2__overlapping(rgb     );
+            v[1] = load_8rgb_pixels__avx2__overlapping(rgb + 24);
+            v[2] = load_8rgb_pixels__avx2__overlapping(rgb + 48);
+            v[3] = load_8rgb_pixels__avx2__precise    (rgb + 72);
+
+            v[0] = _mm256_or_si256(_mm256_shuffle_epi8(v[0], shuffle_mask     ), alpha_mask);
+            v[1] = _mm256_or_si256(_mm256_shuffle_epi8(v[1], shuffle_mask     ), alpha_mask);
+            v[2] = _mm256_or_si256(_mm256_shuffle_epi8(v[2], shuffle_mask     ), alpha_mask);
+            v[3] = _mm256_or_si256(_mm256_shuffle_epi8(v[3], shuffle_mask_last), alpha_mask);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba     ), v[0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 32), v[1]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 64), v[2]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + 96), v[3]);
+
+            rgb  +=  96; // Move forward by 32 pixels in RGB  (32 * 3 =  96)
+            rgba += 128; // Move forward by 32 pixels in RGBA (32 * 4 = 128)
+        }
+    }
+
+    // Handle the remaining pixels (fallback to scalar loop)
+    i = num_32pixel_blocks * 32; // Number of processed pixels
+    for(; i < num_pixels; ++i)
+    {
+        rgba[0] = rgb[0]; // Copy R
+        rgba[1] = rgb[1]; // Copy G
+        rgba[2] = rgb[2]; // Copy B
+        rgba[3] = alpha;  // Fill A
+        rgb  += 3;
+        rgba += 4;
+    }
+}
+
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+// -----------------------------------------------------------------------------
+
+// Public entry point with regular stores: only the dispatch overhead over the kernel. With
+// `store_mode_t::automatic` frames larger than LLC would go to the streaming kernel instead
+void copy_rgba_to_rgb__dispatched_regular(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    copy_rgba_to_rgb(rgba, rgb, num_pixels, store_mode_t::regular);
+}
+
+/*
+    All `rgba --> rgb` kernels, available on this CPU (used by validation and
+    benchmarks). `with_memcpy` adds `copy_rgba_to_rgb__memcpy()` - correct,
+    but not a kernel, used only as a reference point.
+*/
+std::vector<copy_rgba_to_rgb_impl_t> make_copy_rgba_to_rgb_registry(bool with_memcpy = true)
+{
+    std::vector<copy_rgba_to_rgb_impl_t> registry;
+
+    if(with_memcpy)
+    {
+        registry.push_back(copy_rgba_to_rgb_impl_t{"memcpy (1 pixel)", copy_rgba_to_rgb__memcpy});
+    }
+
+    registry.push_back(copy_rgba_to_rgb_impl_t{"raw_pointers (1 pixel)",  copy_rgba_to_rgb__raw_ptr});
+    registry.push_back(copy_rgba_to_rgb_impl_t{"raw_pointers (4 pixels)", copy_rgba_to_rgb__raw_ptr__4pixels});
+    registry.push_back(copy_rgba_to_rgb_impl_t{"swar (4 pixels)",         copy_rgba_to_rgb__swar__4pixels});
+
+    #if COPY_RGBA_TO_RGB__HAS_SSSE3
+    if(get_cpu_features().ssse3)
+    {
+        registry.push_back(copy_rgba_to_rgb_impl_t{"ssse3 (8 pixels)",  copy_rgba_to_rgb__ssse3__8pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"ssse3 (16 pixels)", copy_rgba_to_rgb__ssse3__16pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"ssse3 (32 pixels)", copy_rgba_to_rgb__ssse3__32pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"ssse3 (64 pixels)", copy_rgba_to_rgb__ssse3__64pixels});
+    }
+    #endif
+
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        registry.push_back(copy_rgba_to_rgb_impl_t{"avx2 (8 pixels)",  copy_rgba_to_rgb__avx2__8pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"avx2 (16 pixels)", copy_rgba_to_rgb__avx2__16pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"avx2 (32 pixels)", copy_rgba_to_rgb__avx2__32pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"avx2 (64 pixels)", copy_rgba_to_rgb__avx2__64pixels});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"avx2 (32 pixels, 32-byte stores)", copy_rgba_to_rgb__avx2__32pixels__full_stores});
+        registry.push_back(copy_rgba_to_rgb_impl_t{"avx2 (streaming stores)",          copy_rgba_to_rgb__avx2__stream});
+    }
+    #endif
+
+    registry.push_back(copy_rgba_to_rgb_impl_t{"dispatched",             copy_rgba_to_rgb__dispatched_regular});
+    registry.push_back(copy_rgba_to_rgb_impl_t{"dispatched (automatic)", copy_rgba_to_rgb});
+    registry.push_back(copy_rgba_to_rgb_impl_t{"parallel",               copy_rgba_to_rgb_parallel});
+
+    return registry;
+}
+
+/*
+    Memory bandwidth baselines (roofline): no conversion, only the memory
+    traffic, to see how close the kernels are to what the hardware can do.
+    Same signature as kernels, `num_pixels` defines the amount of traffic:
+
+      - bulk `memcpy()`   - 3N read, 3N written
+      - read + write      - 4N read, 3N written (same as conversion)
+      - read-only (sum)   - 4N read (8 bytes of sum written, to keep it alive)
+      - write-only (fill) - 3N written
+*/
+void bandwidth_baseline__memcpy(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    memcpy(rgb, rgba, num_pixels * 3);
+}
+
+#if COPY_RGBA_TO_RGB__HAS_AVX2
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static void bandwidth_baseline__read_write__avx2(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    const size_t num_32pixel_blocks = num_pixels / 32;
+    for(size_t i = 0; i < num_32pixel_blocks; ++i)
+    {
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba     ));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 32));
+        const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 64));
+        const __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + 96));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb     ), v0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 32), v1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgb + 64), _mm256_xor_si256(v2, v3)); // Consume all 4 loads
+
+        rgba += 128;
+        rgb  +=  96;
+    }
+
+    memcpy(rgb, rgba, (num_pixels % 32) * 3);
+}
+
+COPY_RGBA_TO_RGB__TARGET_AVX2
+static uint64_t bandwidth_baseline__sum__avx2(const uint8_t* data, size_t size)
+{
+    // 4 independent accumulators, to not be limited by the add latency
+    __m256i sum[4] = { _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256() };
+
+    const size_t num_128byte_blocks = size / 128;
+    for(size_t i = 0; i < num_128byte_blocks; ++i)
+    {
+        sum[0] = _mm256_add_epi64(sum[0], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data     )));
+        sum[1] = _mm256_add_epi64(sum[1], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32)));
+        sum[2] = _mm256_add_epi64(sum[2], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 64)));
+        sum[3] = _mm256_add_epi64(sum[3], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 96)));
+        data += 128;
+    }
+
+    const __m256i total = _mm256_add_epi64(_mm256_add_epi64(sum[0], sum[1]), _mm256_add_epi64(sum[2], sum[3]));
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+
+    uint64_t result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for(size_t i = num_128byte_blocks * 128; i < size; ++i)
+    {
+        result += *data++;
+    }
+    return result;
+}
+
+#endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+void bandwidth_baseline__read_write(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        bandwidth_baseline__read_write__avx2(rgba, rgb, num_pixels);
+        return;
+    }
+    #endif
+
+    // Portable: 16 bytes read, 12 bytes written per 4 pixels
+    for(size_t i = 0; i < num_pixels / 4; ++i)
+    {
+        uint32_t w[4];
+        memcpy(w, rgba, 16);
+        w[2] ^= w[3]; // Consume all 4 loads
+        memcpy(rgb, w, 12);
+
+        rgba += 16;
+        rgb  += 12;
+    }
+    memcpy(rgb, rgba, (num_pixels % 4) * 3);
+}
+
+void bandwidth_baseline__read(const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    const size_t size = num_pixels * 4;
+    uint64_t sum = 0;
+
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        sum = bandwidth_baseline__sum__avx2(rgba, size);
+    }
+    else
+    #endif
+    {
+        size_t i = 0;
+        for(; (i + 8) <= size; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, rgba + i, 8);
+            sum += word;
+        }
+        for(; i < size; ++i)
+        {
+            sum += rgba[i];
+        }
+    }
+
+    // Keep the sum alive (otherwise the whole loop may be optimized out)
+    memcpy(rgb, &sum, std::min<size_t>(sizeof(sum), num_pixels * 3));
+}
+
+void bandwidth_baseline__write(const uint8_t* /*rgba*/, uint8_t* rgb, size_t num_pixels)
+{
+    memset(rgb, 0, num_pixels * 3);
+}
+
+struct bandwidth_baseline_t
+{
+    const char*             name;
+    copy_rgba_to_rgb_func_t func;
+    size_t                  bytes_per_pixel; // Read + written
+    bool                    is_roof;         // Counts as achievable bandwidth for conversion (reads and writes)
+};
+
+std::vector<bandwidth_baseline_t> make_bandwidth_baselines()
+{
+    return std::vector<bandwidth_baseline_t>
+    {
+          bandwidth_baseline_t{"baseline: memcpy (bulk, 3N + 3N)", bandwidth_baseline__memcpy,     3 + 3, true }
+        , bandwidth_baseline_t{"baseline: read + write (4N + 3N)", bandwidth_baseline__read_write, 4 + 3, true }
+        , bandwidth_baseline_t{"baseline: read-only sum (4N)",     bandwidth_baseline__read,       4,     false}
+        , bandwidth_baseline_t{"baseline: write-only fill (3N)",   bandwidth_baseline__write,      3,     false}
+    };
+}
+
+// Median throughput of the benchmark result, which moves `num_bytes` per run
+double median_gb_per_second(const ankerl::nanobench::Result& result, size_t num_bytes)
+{
+    const double seconds = result.median(ankerl::nanobench::Result::Measure::elapsed); // Per `run()` call, not divided by batch
+    return (seconds > 0.0) ? (static_cast<double>(num_bytes) / seconds / 1e9) : 0.0;
+}
+
+/*
+    Runs all bandwidth baselines in `b` for `num_pixels` and returns the
+    achievable bandwidth (best of the read + write baselines), in GB/s.
+*/
+double run_bandwidth_baselines(ankerl::nanobench::Bench& b, const uint8_t* rgba, uint8_t* rgb, size_t num_pixels)
+{
+    double achievable_gb_per_second = 0.0;
+
+    for(const bandwidth_baseline_t& baseline : make_bandwidth_baselines())
+    {
+        const copy_rgba_to_rgb_func_t func = baseline.func;
+        b.run(baseline.name, [&]() {
+            func(rgba, rgb, num_pixels);
+        });
+
+        if(baseline.is_roof)
+        {
+            achievable_gb_per_second = std::max(achievable_gb_per_second,
+                median_gb_per_second(b.results().back(), num_pixels * baseline.bytes_per_pixel));
+        }
+    }
+
+    return achievable_gb_per_second;
+}
+
+// Step of source/destination offsets in the alignment sweep benchmark
+#if !defined(COPY_RGBA_TO_RGB__ALIGNMENT_SWEEP__OFFSET_STEP)
+    #define COPY_RGBA_TO_RGB__ALIGNMENT_SWEEP__OFFSET_STEP 1 // Set to 4 or 8 for faster (coarser) sweep
+#endif
+
+/*
+    Minimal time of a single `func()` call, in seconds: best of `num_samples`
+    batches of `num_calls` calls each. Lightweight alternative to nanobench
+    for sweeps with thousands of cases (like alignment sweep).
+*/
+template<typename Func>
+double measure_min_seconds_per_call(const Func& func, size_t num_samples = 7, size_t num_calls = 32)
+{
+    using clock_t = std::chrono::steady_clock;
+
+    func(); // Warm up (caches, TLB, branch predictors)
+
+    double min_seconds = 0.0;
+    for(size_t sample = 0; sample < num_samples; ++sample)
+    {
+        const clock_t::time_point start = clock_t::now();
+        for(size_t call = 0; call < num_calls; ++call)
+        {
+            func();
+        }
+        const double seconds = std::chrono::duration<double>(clock_t::now() - start).count() / static_cast<double>(num_calls);
+
+        if((sample == 0) || (seconds < min_seconds))
+        {
+            min_seconds = seconds;
+        }
+    }
+
+    return min_seconds;
+}
+
+// -----------------------------------------------------------------------------
+// Cold cache: evicting buffers between timed calls
+
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+#if COPY_RGBA_TO_RGB__X86
+COPY_RGBA_TO_RGB__TARGET_CLFLUSHOPT
+void evict_from_caches__clflushopt(const uint8_t* begin, const uint8_t* end)
+{
+    for(const uint8_t* line = begin; line < end; line += CACHE_LINE_SIZE)
+    {
+        _mm_clflushopt(const_cast<uint8_t*>(line));
+    }
+    _mm_mfence(); // `clflushopt` is weakly ordered: wait for all of them
+}
+
+void evict_from_caches__clflush(const uint8_t* begin, const uint8_t* end)
+{
+    for(const uint8_t* line = begin; line < end; line += CACHE_LINE_SIZE)
+    {
+        _mm_clflush(line);
+    }
+    _mm_mfence();
+}
+#else
+// Portable fallback: streams through scratch buffer of twice the last-level cache size
+void evict_from_caches__scratch()
+{
+    static std::vector<uint8_t> scratch(2 * detect_last_level_cache_size(), 0);
+
+    // Read-modify-write of a static buffer can't be optimized away, and evicts dirty lines too
+    for(size_t i = 0; i < scratch.size(); i += CACHE_LINE_SIZE)
+    {
+        scratch[i] = static_cast<uint8_t>(scratch[i] + 1);
+    }
+}
+#endif // COPY_RGBA_TO_RGB__X86
+
+/*
+    Evicts `[ptr, ptr + size)` from all cache levels (of all cores), as if the
+    buffer was just written by DMA or by other device. `clflushopt` (where
+    available) is much faster than `clflush`, which is serialized per line.
+*/
+void evict_from_caches(const void* ptr, size_t size)
+{
+    #if COPY_RGBA_TO_RGB__X86
+    {
+        const uint8_t* const begin = reinterpret_cast<const uint8_t*>(reinterpret_cast<uintptr_t>(ptr) & ~(uintptr_t)(CACHE_LINE_SIZE - 1));
+        const uint8_t* const end   = static_cast<const uint8_t*>(ptr) + size;
+
+        if(get_cpu_features().clflushopt)
+        {
+            evict_from_caches__clflushopt(begin, end);
+        }
+        else
+        {
+            evict_from_caches__clflush(begin, end);
+        }
+    }
+    #else
+    {
+        (void)ptr;
+        (void)size;
+        evict_from_caches__scratch();
+    }
+    #endif // COPY_RGBA_TO_RGB__X86
+}
+
+// First-touch and hot-cache time of a single call, in seconds (median and all samples)
+struct cold_warm_seconds_t
+{
+    double cold;
+    double warm;
+
+    std::vector<double> cold_samples;
+    std::vector<double> warm_samples;
+};
+
+/*
+    Times `num_samples` single calls of `func()` with caches flushed by
+    `evict()` before each of them (flush is not timed), and the same number
+    of calls on hot caches. Medians are returned: with one call per sample
+    the minimum would be dominated by lucky outliers (prefetched lines).
+*/
+template<typename Func, typename Evict>
+cold_warm_seconds_t measure_cold_and_warm_seconds_per_call(const Func& func, const Evict& evict, size_t num_samples)
+{
+    using clock_t = std::chrono::steady_clock;
+
+    std::vector<double> cold(num_samples, 0.0);
+    std::vector<double> warm(num_samples, 0.0);
+
+    func(); // Page faults of the first call are not a part of either measurement
+
+    for(size_t sample = 0; sample < num_samples; ++sample)
+    {
+        evict();
+
+        const clock_t::time_point start = clock_t::now();
+        func();
+        cold[sample] = std::chrono::duration<double>(clock_t::now() - start).count();
+    }
+
+    func(); // Warm up
+    for(size_t sample = 0; sample < num_samples; ++sample)
+    {
+        const clock_t::time_point start = clock_t::now();
+        func();
+        warm[sample] = std::chrono::duration<double>(clock_t::now() - start).count();
+    }
+
+    cold_warm_seconds_t seconds;
+    seconds.cold_samples = cold;
+    seconds.warm_samples = warm;
+
+    std::sort(cold.begin(), cold.end());
+    std::sort(warm.begin(), warm.end());
+    seconds.cold = cold[num_samples / 2];
+    seconds.warm = warm[num_samples / 2];
+
+    return seconds;
+}
+
+// Validates all kernels for given channel orders, returns number of failed cases
+template<typename SrcOrder, typename DstOrder>
+size_t validate_4ch_to_3ch(const char* orders_name)
+{
+    using test_func_t = void (*) (const uint8_t*, uint8_t*, size_t);
+    using test_name_and_func_t = std::pair< const char*, test_func_t >;
+    std::vector< test_name_and_func_t > registry
+    {
+          test_name_and_func_t{"raw_pointers (1 pixel)", copy_4ch_to_3ch__raw_ptr<SrcOrder, DstOrder>}
+        , test_name_and_func_t{"dispatched",             copy_4ch_to_3ch<SrcOrder, DstOrder>}
+    };
+
+    #if COPY_RGBA_TO_RGB__HAS_SSSE3
+    if(get_cpu_features().ssse3)
+    {
+        registry.push_back(test_name_and_func_t{"ssse3 (8 pixels)",  copy_4ch_to_3ch__ssse3<SrcOrder, DstOrder,  8>});
+        registry.push_back(test_name_and_func_t{"ssse3 (32 pixels)", copy_4ch_to_3ch__ssse3<SrcOrder, DstOrder, 32>});
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_SSSE3
+
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        registry.push_back(test_name_and_func_t{"avx2 (8 pixels)",                  copy_4ch_to_3ch__avx2__8pixels<SrcOrder, DstOrder>});
+        registry.push_back(test_name_and_func_t{"avx2 (16 pixels)",                 copy_4ch_to_3ch__avx2__16pixels<SrcOrder, DstOrder>});
+        registry.push_back(test_name_and_func_t{"avx2 (32 pixels)",                 copy_4ch_to_3ch__avx2__32pixels<SrcOrder, DstOrder>});
+        registry.push_back(test_name_and_func_t{"avx2 (64 pixels)",                 copy_4ch_to_3ch__avx2__64pixels<SrcOrder, DstOrder>});
+        registry.push_back(test_name_and_func_t{"avx2 (32 pixels, 32-byte stores)", copy_4ch_to_3ch__avx2__32pixels__full_stores<SrcOrder, DstOrder>});
+        registry.push_back(test_name_and_func_t{"avx2 (streaming stores)",          copy_4ch_to_3ch__avx2__stream<SrcOrder, DstOrder>});
+        registry.push_back(test_name_and_func_t{"avx2 (row)", [](const uint8_t* src, uint8_t* dst, size_t num_pixels) {
+            copy_4ch_to_3ch__avx2__row<SrcOrder, DstOrder>(src, dst, num_pixels, 0);
+        }});
+    }
+    #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+    std::vector<size_t> num_pixels_cases;
+    for(size_t i = 0; i <= 200; ++i)
+    {
+        num_pixels_cases.push_back(i);
+    }
+    num_pixels_cases.push_back(1920 * 1080);
+
+    size_t num_failed = 0;
+    for(const size_t num_pixels : num_pixels_cases)
+    {
+        const std::vector<uint8_t> src = make_ascending_data(num_pixels * 4);
+
+        for(const test_name_and_func_t& t : registry)
+        {
+            std::vector<uint8_t> dst(num_pixels * 3, 0);
+
+            t.second(src.data(), dst.data(), num_pixels);
+
+            if( compare_4ch_to_3ch<SrcOrder, DstOrder>(src.data(), dst.data(), num_pixels) == false )
+            {
+                fprintf(stdout, "%s: %s failed for %zu pixels\n", orders_name, t.first, num_pixels);
+                fflush(stdout);
+                ++num_failed;
+            }
+        }
+    }
+    return num_failed;
+}
+
+template<typename SrcOrder, typename DstOrder>
+void run_4ch_to_3ch_benchmark(ankerl::nanobench::Bench& b, const char* name, const uint8_t* src, uint8_t* dst, size_t num_pixels)
+{
+    b.run(name, [&]() {
+        copy_4ch_to_3ch<SrcOrder, DstOrder>(src, dst, num_pixels);
+    });
+}
+
+// -----------------------------------------------------------------------------
+// Guard-page fuzzing: out-of-bounds reads and writes of kernels
+
+/*
+    Anonymous mapping with inaccessible (`PROT_NONE`) guard pages before and
+    after `size` usable bytes: any access outside of them faults immediately,
+    even if it's a single byte.
+
+        | guard page | usable (rounded up to pages) | guard page |
+                     ^ begin()                      ^ end()
+*/
+class guarded_buffer_t
+{
+public:
+    explicit guarded_buffer_t(size_t size)
+    {
+        m_page_size   = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        m_usable_size = ((size + m_page_size - 1) / m_page_size) * m_page_size;
+        if(m_usable_size == 0)
+        {
+            m_usable_size = m_page_size;
+        }
+        m_mapping_size = m_usable_size + (2 * m_page_size);
+
+        void* ptr = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(ptr == MAP_FAILED)
+        {
+            return;
+        }
+        m_mapping = static_cast<uint8_t*>(ptr);
+
+        mprotect(m_mapping,                                 m_page_size, PROT_NONE); // Leading  guard page
+        mprotect(m_mapping + m_page_size + m_usable_size, m_page_size, PROT_NONE); // Trailing guard page
+    }
+
+    ~guarded_buffer_t()
+    {
+        if(m_mapping != nullptr)
+        {
+            munmap(m_mapping, m_mapping_size);
+        }
+    }
+
+    guarded_buffer_t(const guarded_buffer_t&) = delete;
+    guarded_buffer_t& operator=(const guarded_buffer_t&) = delete;
+
+    bool     valid() const { return m_mapping != nullptr; }
+    uint8_t* begin() const { return m_mapping + m_page_size; }
+    uint8_t* end()   const { return m_mapping + m_page_size + m_usable_size; }
+    size_t   size()  const { return m_usable_size; }
+
+private:
+    uint8_t* m_mapping      = nullptr;
+    size_t   m_mapping_size = 0;
+    size_t   m_usable_size  = 0;
+    size_t   m_page_size    = 0;
+};
+
+/*
+    Kernel under fuzzing: `src_bpp`/`dst_bpp` bytes per pixel of input and
+    output. `dst_slack` - number of bytes after the output, which kernel is
+    allowed to clobber (row padding of 2D kernels). `check()` validates the
+    output (the input is filled with random data).
+*/
+struct fuzz_kernel_t
+{
+    using run_t   = std::function<void (const uint8_t* src, uint8_t* dst, size_t num_pixels)>;
+    using check_t = std::function<bool (const uint8_t* src, const uint8_t* dst, size_t num_pixels)>;
+
+    std::string name;
+    size_t      src_bpp;
+    size_t      dst_bpp;
+    size_t      dst_slack;
+    run_t       run;
+    check_t     check;
+    size_t      dst_alignment; // Of `dst` (e.g. 4 for `float` output): canary after output is rounded down to it
+
+    fuzz_kernel_t(std::string name_, size_t src_bpp_, size_t dst_bpp_, size_t dst_slack_, run_t run_, check_t check_, size_t dst_alignment_ = 1)
+        : name(std::move(name_)), src_bpp(src_bpp_), dst_bpp(dst_bpp_), dst_slack(dst_slack_)
+        , run(std::move(run_)), check(std::move(check_)), dst_alignment(dst_alignment_)
+    {}
+};
+
+std::vector<fuzz_kernel_t> make_fuzz_kernels()
+{
+    std::vector<fuzz_kernel_t> kernels;
+
+    // All `rgba --> rgb` kernels (except `memcpy`, which is not a kernel)
+    for(const copy_rgba_to_rgb_impl_t& impl : make_copy_rgba_to_rgb_registry(false))
+    {
+        const copy_rgba_to_rgb_func_t func = impl.func;
+        kernels.push_back(fuzz_kernel_t{impl.name, 4, 3, 0, func, compare_rgba_to_rgb});
+    }
+
+    kernels.push_back(fuzz_kernel_t{"copy_4ch_to_3ch<bgra, bgr>", 4, 3, 0,
+        copy_4ch_to_3ch<bgra_order_t, bgr_order_t>, compare_4ch_to_3ch<bgra_order_t, bgr_order_t>});
+    kernels.push_back(fuzz_kernel_t{"copy_4ch_to_3ch<argb, rgb>", 4, 3, 0,
+        copy_4ch_to_3ch<argb_order_t, rgb_order_t>, compare_4ch_to_3ch<argb_order_t, rgb_order_t>});
+
+    kernels.push_back(fuzz_kernel_t{"copy_rgba_to_rgb_batch (1 image)", 4, 3, 0,
+        [](const uint8_t* src, uint8_t* dst, size_t n) {
+            const copy_rgba_to_rgb_job_t job{src, dst, n};
+            copy_rgba_to_rgb_batch(&job, 1);
+        }, compare_rgba_to_rgb});
+
+    // Fused 2x downscale of 2 rows: 4 input pixels per output pixel
+    kernels.push_back(fuzz_kernel_t{"copy_rgba_to_rgb_downscale_2x (2 rows)", 16, 3, 0,
+        [](const uint8_t* src, uint8_t* dst, size_t n) {
+            copy_rgba_to_rgb_downscale_2x(src, static_cast<ptrdiff_t>(n * 8), dst, static_cast<ptrdiff_t>(n * 3), n * 2, 2);
+        },
+        [](const uint8_t* src, const uint8_t* dst, size_t n) {
+            std::vector<uint8_t> expected(n * 3 + 1);
+            copy_rgba_to_rgb_downscale_2x__raw_ptr(src, static_cast<ptrdiff_t>(n * 8), expected.data(), static_cast<ptrdiff_t>(n * 3), n * 2, 2);
+            return (n == 0) || (memcmp(expected.data(), dst, n * 3) == 0);
+        }});
+
+    // Planar outputs: 3 planes of `n` bytes (or floats) one after another
+    kernels.push_back(fuzz_kernel_t{"copy_rgba_to_planar", 4, 3, 0,
+        copy_rgba_to_planar,
+        [](const uint8_t* src, const uint8_t* dst, size_t n) {
+            std::vector<uint8_t> expected(n * 3 + 1);
+            copy_rgba_to_planar__raw_ptr(src, expected.data(), n);
+            return (n == 0) || (memcmp(expected.data(), dst, n * 3) == 0);
+        }});
+    kernels.push_back(fuzz_kernel_t{"copy_rgba_to_planar_float", 4, 12, 0,
+        [](const uint8_t* src, uint8_t* dst, size_t n) {
+            copy_rgba_to_planar_float(src, reinterpret_cast<float*>(dst), n, IMAGENET_NORMALIZATION);
+        },
+        [](const uint8_t* src, const uint8_t* dst, size_t n) {
+            std::vector<float> expected(n * 3 + 1);
+            std::vector<float> actual  (n * 3 + 1);
+            copy_rgba_to_planar_float__raw_ptr(src, expected.data(), n, IMAGENET_NORMALIZATION);
+            memcpy(actual.data(), dst, n * 12);
+            for(size_t i = 0; i < n * 3; ++i)
+            {
+                if(std::fabs(actual[i] - expected[i]) > 1e-5f) { return false; }
+            }
+            return true;
+        }, alignof(float)});
+
+    // YUV 4:2:0 of `height` rows of `n` pixels (odd widths and heights): planes are one after
+    // another (Y, then U and V, or UV), the last one ends flush with the buffer. `dst_slack` -
+    // rounding up of chroma (odd widths): it is before the Y plane, when unused
+    for(const size_t height : {1, 3})
+    {
+        const size_t chroma_rows = (height + 1) / 2;
+        const size_t dst_bpp     = height + chroma_rows;
+        const size_t dst_slack   = chroma_rows;
+
+        const auto planes_at = [height, chroma_rows, dst_bpp, dst_slack](uint8_t* dst, size_t n, bool interleaved_uv) {
+            const size_t chroma_width = (n + 1) / 2;
+            uint8_t* const y = dst + (n * dst_bpp) + dst_slack - (n * height) - (2 * chroma_width * chroma_rows);
+            uint8_t* const u = y + (n * height);
+            return interleaved_uv
+                ? yuv420_planes_t{y, static_cast<ptrdiff_t>(n), u, static_cast<ptrdiff_t>(2 * chroma_width), nullptr, 0}
+                : yuv420_planes_t{y, static_cast<ptrdiff_t>(n), u, static_cast<ptrdiff_t>(chroma_width),
+                                  u + (chroma_width * chroma_rows), static_cast<ptrdiff_t>(chroma_width)};
+        };
+        const auto check_yuv420 = [height, chroma_rows, dst_bpp, dst_slack, planes_at](const uint8_t* src, const uint8_t* dst, size_t n,
+                                                                                       bool interleaved_uv, yuv_matrix_t matrix, yuv_range_t range) {
+            const size_t size = (n * height) + (2 * ((n + 1) / 2) * chroma_rows);
+            const size_t skip = (n * dst_bpp) + dst_slack - size;
+
+            std::vector<uint8_t> expected((n * dst_bpp) + dst_slack + 1);
+            const yuv420_planes_t planes = planes_at(expected.data(), n, interleaved_uv);
+            if(interleaved_uv)
+            {
+                copy_rgba_to_yuv420__raw_ptr<true> (src, static_cast<ptrdiff_t>(n * 4), planes, n, height, matrix, range);
+            }
+            else
+            {
+                copy_rgba_to_yuv420__raw_ptr<false>(src, static_cast<ptrdiff_t>(n * 4), planes, n, height, matrix, range);
+            }
+            return (size == 0) || (memcmp(expected.data() + skip, dst + skip, size) == 0);
+        };
+
+        const std::string rows = " (" + std::to_string(height) + ((height == 1) ? " row)" : " rows)");
+        kernels.push_back(fuzz_kernel_t{"copy_rgba_to_i420" + rows, 4 * height, dst_bpp, dst_slack,
+            [height, planes_at](const uint8_t* src, uint8_t* dst, size_t n) {
+                const yuv420_planes_t p = planes_at(dst, n, false);
+                copy_rgba_to_i420(src, static_cast<ptrdiff_t>(n * 4), p.y, p.y_pitch, p.u, p.u_pitch, p.v, p.v_pitch,
+                                  n, height, yuv_matrix_t::bt709, yuv_range_t::limited);
+            },
+            [check_yuv420](const uint8_t* src, const uint8_t* dst, size_t n) {
+                return check_yuv420(src, dst, n, false, yuv_matrix_t::bt709, yuv_range_t::limited);
+            }});
+        kernels.push_back(fuzz_kernel_t{"copy_rgba_to_nv12" + rows, 4 * height, dst_bpp, dst_slack,
+            [height, planes_at](const uint8_t* src, uint8_t* dst, size_t n) {
+                const yuv420_planes_t p = planes_at(dst, n, true);
+                copy_rgba_to_nv12(src, static_cast<ptrdiff_t>(n * 4), p.y, p.y_pitch, p.u, p.u_pitch,
+                                  n, height, yuv_matrix_t::bt601, yuv_range_t::full);
+            },
+            [check_yuv420](const uint8_t* src, const uint8_t* dst, size_t n) {
+                return check_yuv420(src, dst, n, true, yuv_matrix_t::bt601, yuv_range_t::full);
+            }});
+    }
+
+    // 2D with bottom-up destination: 3 rows of `n` pixels, `n` bytes of padding,
+    // the row 0 is the last one in memory (and ends flush with the buffer)
+    kernels.push_back(fuzz_kernel_t{"copy_rgba_to_rgb_2d (3 rows, bottom-up dst)", 12, 11, 0,
+        [](const uint8_t* src, uint8_t* dst, size_t n) {
+            copy_rgba_to_rgb_2d(src, static_cast<ptrdiff_t>(n * 4), dst + (n * 8), -static_cast<ptrdiff_t>(n * 4), n, 3);
+        },
+        [](const uint8_t* src, const uint8_t* dst, size_t n) {
+            for(size_t y = 0; y < 3; ++y)
+            {
+                if(compare_rgba_to_rgb(src + (y * n * 4), dst + ((2 - y) * n * 4), n) == false) { return false; }
+            }
+            return true;
+        }});
+
+    // Row kernels may clobber `dst_slack` bytes of row padding
+    for(const size_t dst_slack : {0, 1, 3, 4, 16})
+    {
+        kernels.push_back(fuzz_kernel_t{"row: dispatched (slack " + std::to_string(dst_slack) + ")", 4, 3, dst_slack,
+            [dst_slack](const uint8_t* src, uint8_t* dst, size_t n) { copy_rgba_to_rgb__dispatched__row(src, dst, n, dst_slack); },
+            compare_rgba_to_rgb});
+
+        #if COPY_RGBA_TO_RGB__HAS_AVX2
+        if(get_cpu_features().avx2)
+        {
+            kernels.push_back(fuzz_kernel_t{"row: avx2 (slack " + std::to_string(dst_slack) + ")", 4, 3, dst_slack,
+                [dst_slack](const uint8_t* src, uint8_t* dst, size_t n) { copy_rgba_to_rgb__avx2__row(src, dst, n, dst_slack); },
+                compare_rgba_to_rgb});
+        }
+        #endif
+    }
+
+    // In-place: input is copied into the output buffer (4 bytes per pixel, flush with its guard
+    // page), and converted there. Only the first `3 * n` bytes are defined after the call
+    using inplace_func_t = void (*) (uint8_t*, size_t);
+    std::vector< std::pair<const char*, inplace_func_t> > inplace_kernels
+    {
+          {"inplace: raw_pointers (1 pixel)", rgba_to_rgb_inplace__raw_ptr}
+        , {"inplace: dispatched",             rgba_to_rgb_inplace}
+    };
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        inplace_kernels.push_back({"inplace: avx2 (32 pixels)", rgba_to_rgb_inplace__avx2__32pixels});
+    }
+    #endif
+    for(const auto& inplace : inplace_kernels)
+    {
+        const inplace_func_t func = inplace.second;
+        kernels.push_back(fuzz_kernel_t{inplace.first, 4, 4, 0,
+            [func](const uint8_t* src, uint8_t* dst, size_t n) {
+                if(n > 0) { memcpy(dst, src, n * 4); }
+                func(dst, n);
+            }, compare_rgba_to_rgb});
+    }
+
+    // Reverse expansion (constant alpha)
+    static constexpr uint8_t ALPHA = 0xC3;
+    const auto check_rgb_to_rgba = [](const uint8_t* src, const uint8_t* dst, size_t n) { return compare_rgb_to_rgba(src, dst, n, ALPHA); };
+
+    kernels.push_back(fuzz_kernel_t{"rgb to rgba: raw_pointers", 3, 4, 0,
+        [](const uint8_t* src, uint8_t* dst, size_t n) { copy_rgb_to_rgba__raw_ptr(src, dst, n, ALPHA); }, check_rgb_to_rgba});
+
+    // Alpha compositing (against scalar reference)
+    static constexpr uint8_t BG_R = 10, BG_G = 128, BG_B = 250;
+    const auto check_blend = [](const uint8_t* src, const uint8_t* dst, size_t n) {
+        std::vector<uint8_t> expected(n * 3, 0);
+        blend_rgba_over_rgb__raw_ptr(src, expected.data(), n, BG_R, BG_G, BG_B);
+        return (n == 0) || (memcmp(expected.data(), dst, n * 3) == 0);
+    };
+
+    #if COPY_RGBA_TO_RGB__HAS_AVX2
+    if(get_cpu_features().avx2)
+    {
+        kernels.push_back(fuzz_kernel_t{"rgb to rgba: avx2 (8 pixels)", 3, 4, 0,
+            [](const uint8_t* src, uint8_t* dst, size_t n) { copy_rgb_to_rgba__avx2__8pixels(src, dst, n, ALPHA); }, check_rgb_to_rgba});
+        kernels.push_back(fuzz_kernel_t{"rgb to rgba: avx2 (32 pixels)", 3, 4, 0,
+            [](const uint8_t* src, uint8_t* dst, size_t n) { copy_rgb_to_rgba__avx2__32pixels(src, dst, n, ALPHA); }, check_rgb_to_rgba});
+        kernels.push_back(fuzz_kernel_t{"blend: avx2 (8 pixels)", 4, 3, 0,
+            [](const uint8_t* src, uint8_t* dst, size_t n) { blend_rgba_over_rgb__avx2__8pixels(src, dst, n, BG_R, BG_G, BG_B); }, check_blend});
+    }
+    #endif
+
+    return kernels;
+}
+
+// State for SIGSEGV/SIGBUS handler: fault of the fuzzed kernel jumps back into the fuzzing loop
+static sigjmp_buf           g_fuzz_jump_buffer;
+static volatile sig_atomic_t g_fuzz_in_kernel = 0;
+static pthread_t            g_fuzz_thread;
+
+static void fuzz_fault_handler(int signal_number)
+{
+    if(g_fuzz_in_kernel && pthread_equal(pthread_self(), g_fuzz_thread))
+    {
+        g_fuzz_in_kernel = 0;
+        siglongjmp(g_fuzz_jump_buffer, signal_number);
+    }
+
+    // Fault on another thread (parallel kernel), or outside of the kernel: can't recover
+    static const char MESSAGE[] = "guard-page fuzzing: fatal fault outside of the fuzzing thread\n";
+    const ssize_t written = write(STDERR_FILENO, MESSAGE, sizeof(MESSAGE) - 1);
+    (void)written;
+    _exit(1);
+}
+
+/*
+    Runs the kernel, returns 0, or the number of the signal of its fault.
+
+    NOTE: a separate function, so no (non-volatile) locals of the fuzzing loop
+    are live across `siglongjmp()` - their values would be indeterminate.
+*/
+static int run_fuzz_kernel(const fuzz_kernel_t& kernel, const uint8_t* src, uint8_t* dst, size_t num_pixels)
+{
+    const int signal_number = sigsetjmp(g_fuzz_jump_buffer, 1);
+    if(signal_number != 0)
+    {
+        return signal_number;
+    }
+
+    g_fuzz_in_kernel = 1;
+    kernel.run(src, dst, num_pixels);
+    g_fuzz_in_kernel = 0;
+
+    return 0;
+}
+
+/*
+    Runs every kernel on `num_cases` random cases, returns number of failed
+    (kernel, case) pairs. For each case:
+
+      - Size: mostly small (up to 600 pixels, all remainders of all block
+        sizes), sometimes large (up to 64K pixels).
+      - Input: flush against the trailing guard page (over-read faults), or
+        against the leading one (under-read faults).
+      - Output: flush against the trailing guard page, or followed by 1..63
+        canary bytes (random alignment, rounded down to `dst_alignment` of
+        the kernel), and preceded by 64 canary bytes.
+        `dst_slack` bytes after the output may be changed, canaries - never.
+*/
+size_t fuzz_kernels_with_guard_pages(size_t num_cases, uint32_t seed)
+{
+    static constexpr size_t  CANARY_BEFORE = 64;
+    static constexpr uint8_t CANARY        = 0xA5;
+
+    const std::vector<fuzz_kernel_t> kernels = make_fuzz_kernels();
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = fuzz_fault_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_NODEFER;
+
+    struct sigaction old_segv, old_bus;
+    sigaction(SIGSEGV, &action, &old_segv);
+    sigaction(SIGBUS,  &action, &old_bus);
+    g_fuzz_thread = pthread_self();
+
+    std::mt19937 rng(seed);
+    size_t num_failed = 0;
+
+    for(size_t c = 0; c < num_cases; ++c)
+    {
+        const size_t num_pixels = ((rng() % 8) == 0) ? (rng() % (64 * 1024)) : (rng() % 601);
+
+        const bool   src_flush_end = (rng() % 4) != 0;
+        const size_t case_canary_after = ((rng() % 2) == 0) ? 0 : (1 + rng() % 63);
+
+        for(const fuzz_kernel_t& kernel : kernels)
+        {
+            const size_t canary_after = case_canary_after - (case_canary_after % kernel.dst_alignment);
+            const size_t src_size     = num_pixels * kernel.src_bpp;
+            const size_t dst_size     = num_pixels * kernel.dst_bpp;
+
+            guarded_buffer_t src_buffer(src_size);
+            guarded_buffer_t dst_buffer(CANARY_BEFORE + dst_size + kernel.dst_slack + canary_after);
+            if(src_buffer.valid() == false || dst_buffer.valid() == false)
+            {
+                fprintf(stdout, "guard-page fuzzing: mmap failed\n");
+                return num_failed + 1;
+            }
+
+            uint8_t* const src = src_flush_end ? (src_buffer.end() - src_size) : src_buffer.begin();
+            for(size_t i = 0; i < src_size; ++i)
+            {
+                src[i] = static_cast<uint8_t>(rng());
+            }
+
+            uint8_t* const dst = dst_buffer.end() - canary_after - kernel.dst_slack - dst_size;
+            memset(dst_buffer.begin(), CANARY, dst_buffer.size());
+
+            const char* failure = nullptr;
+            const int signal_number = run_fuzz_kernel(kernel, src, dst, num_pixels);
+            if(signal_number == 0)
+            {
+                if(kernel.check(src, dst, num_pixels) == false)
+                {
+                    failure = "wrong output";
+                }
+                else if(std::any_of(dst - CANARY_BEFORE, dst, [](uint8_t v) { return v != CANARY; }))
+                {
+                    failure = "canary before output changed (underflow)";
+                }
+                else if(std::any_of(dst + dst_size + kernel.dst_slack, dst_buffer.end(), [](uint8_t v) { return v != CANARY; }))
+                {
+                    failure = "canary after output changed (overflow)";
+                }
+            }
+            else
+            {
+                failure = (signal_number == SIGSEGV) ? "SIGSEGV (guard page access)" : "SIGBUS";
+            }
+
+            if(failure != nullptr)
+            {
+                fprintf(stdout, "guard-page fuzzing: %s failed for %zu pixels (src %s, canary after %zu): %s\n",
+                        kernel.name.c_str(), num_pixels, src_flush_end ? "flush end" : "flush begin", canary_after, failure);
+                fflush(stdout);
+                ++num_failed;
+            }
+        }
+    }
+
+    sigaction(SIGSEGV, &old_segv, nullptr);
+    sigaction(SIGBUS,  &old_bus,  nullptr);
+
+    return num_failed;
+}
+
+// -----------------------------------------------------------------------------
+// Tools: streaming converter (stdin --> stdout), file conversion (mmap)
+
+// Reads until `size` bytes or end of file. Returns number of bytes read, or -1 on error
+ssize_t read_fully(int fd, uint8_t* data, size_t size)
+{
+    size_t done = 0;
+    while(done < size)
+    {
+        const ssize_t n = read(fd, data + done, size - done);
+        if(n > 0)
+        {
+            done += static_cast<size_t>(n);
+        }
+        else if(n == 0)
+        {
+            break;
+        }
+        else if(errno != EINTR)
+        {
+            return -1;
+        }
+    }
+    return static_cast<ssize_t>(done);
+}
+
+bool write_fully(int fd, const uint8_t* data, size_t size)
+{
+    size_t done = 0;
+    while(done < size)
+    {
+        const ssize_t n = write(fd, data + done, size - done);
+        if(n > 0)
+        {
+            done += static_cast<size_t>(n);
+        }
+        else if((n < 0) && (errno != EINTR))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+    Bounded multi-producer/multi-consumer queue. After `close()` `push()` is
+    ignored, and `pop()` returns `false` (instead of blocking) once the queue
+    is empty. Time spent blocked in `pop()` is accumulated into `stall_seconds`.
+*/
+template<typename T>
+class blocking_queue_t
+{
+public:
+    void push(const T& value)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_closed)
+            {
+                return;
+            }
+            m_items.push_back(value);
+        }
+        m_cv.notify_one();
+    }
+
+    bool pop(T& value, double& stall_seconds)
+    {
+        using clock_t = std::chrono::steady_clock;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if(m_items.empty() && (m_closed == false))
+        {
+            const clock_t::time_point start = clock_t::now();
+            m_cv.wait(lock, [this]() { return (m_items.empty() == false) || m_closed; });
+            stall_seconds += std::chrono::duration<double>(clock_t::now() - start).count();
+        }
+        if(m_items.empty())
+        {
+            return false;
+        }
+        value = m_items.front();
+        m_items.pop_front();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_cv.notify_all();
+    }
+
+private:
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+    std::deque<T>           m_items;
+    bool                    m_closed = false;
+};
+
+// Per-stage time of `convert_rgba_stream()`, in seconds: busy (doing own work) and stalled (waiting for other stages)
+struct stream_stats_t
+{
+    size_t num_frames = 0;
+    double seconds    = 0.0;
+
+    double reader_busy             = 0.0; // In `read()`, including waiting for upstream producer
+    double reader_stall            = 0.0; // No free input buffer: converter is behind
+    double converter_busy          = 0.0;
+    double converter_stall_input   = 0.0; // No frame to convert: reader is behind
+    double converter_stall_output  = 0.0; // No free output buffer: writer is behind
+    double writer_busy             = 0.0; // In `write()`, including waiting for downstream consumer
+    double writer_stall            = 0.0; // No converted frame: converter is behind
+};
+
+/*
+    Converts raw RGBA frames of `num_pixels` from `input_fd` into raw RGB
+    frames to `output_fd` (like `ffmpeg -f rawvideo -pix_fmt rgba` piped into
+    encoder, expecting `-pix_fmt rgb24`), until end of input.
+
+    Reading, converting and writing overlap: reader thread, converter (the
+    calling thread) and writer thread pass indices of `num_buffers`
+    preallocated input and output frames through queues:
+
+        free input --> reader --> full input --> converter --> full output --> writer
+             ^                                  |       |                      |
+             +----------------------------------+       +-- free output <------+
+
+    Trailing incomplete frame is dropped (with a warning). Returns `false` on
+    read or write error (e.g. closed downstream pipe).
+*/
+bool convert_rgba_stream(int input_fd, int output_fd, size_t num_pixels, size_t num_buffers, stream_stats_t& stats)
+{
+    using clock_t = std::chrono::steady_clock;
+
+    const auto seconds_since = [](clock_t::time_point start) { return std::chrono::duration<double>(clock_t::now() - start).count(); };
+
+    num_buffers = std::max<size_t>(num_buffers, 2);
+
+    const size_t input_frame_size  = num_pixels * 4;
+    const size_t output_frame_size = num_pixels * 3;
+
+    std::vector< std::vector<uint8_t> > input_frames (num_buffers, std::vector<uint8_t>(input_frame_size));
+    std::vector< std::vector<uint8_t> > output_frames(num_buffers, std::vector<uint8_t>(output_frame_size));
+
+    blocking_queue_t<size_t> free_input, full_input, free_output, full_output;
+    for(size_t i = 0; i < num_buffers; ++i)
+    {
+        free_input.push(i);
+        free_output.push(i);
+    }
+
+    std::atomic<bool> failed(false);
+    const auto fail = [&]() {
+        failed = true;
+        free_input.close();
+        full_input.close();
+        free_output.close();
+        full_output.close();
+    };
+
+    stats = stream_stats_t();
+    const clock_t::time_point start = clock_t::now();
+
+    std::thread reader([&]() {
+        size_t index = 0;
+        while((failed == false) && free_input.pop(index, stats.reader_stall))
+        {
+            const clock_t::time_point read_start = clock_t::now();
+            const ssize_t size = read_fully(input_fd, input_frames[index].data(), input_frame_size);
+            stats.reader_busy += seconds_since(read_start);
+
+            if(size < 0)
+            {
+                fprintf(stderr, "stream: read failed: %s\n", strerror(errno));
+                fail();
+                break;
+            }
+            if(static_cast<size_t>(size) != input_frame_size)
+            {
+                if(size > 0)
+                {
+                    fprintf(stderr, "stream: trailing incomplete frame (%zd of %zu bytes) dropped\n", size, input_frame_size);
+                }
+                break;
+            }
+            full_input.push(index);
+        }
+        full_input.close(); // End of input: converter drains the rest
+    });
+
+    std::thread writer([&]() {
+        size_t index = 0;
+        while(full_output.pop(index, stats.writer_stall))
+        {
+            const clock_t::time_point write_start = clock_t::now();
+            const bool ok = write_fully(output_fd, output_frames[index].data(), output_frame_size);
+            stats.writer_busy += seconds_since(write_start);
+
+            if(ok == false)
+            {
+                fprintf(stderr, "stream: write failed: %s\n", strerror(errno));
+                fail();
+                break;
+            }
+            ++stats.num_frames; // Written, not just converted
+            free_output.push(index);
+        }
+    });
+
+    size_t input_index = 0, output_index = 0;
+    while(full_input.pop(input_index, stats.converter_stall_input) && free_output.pop(output_index, stats.converter_stall_output))
+    {
+        const clock_t::time_point convert_start = clock_t::now();
+        copy_rgba_to_rgb(input_frames[input_index].data(), output_frames[output_index].data(), num_pixels);
+        stats.converter_busy += seconds_since(convert_start);
+
+        free_input.push(input_index);
+        full_output.push(output_index);
+    }
+    full_output.close(); // Writer drains the rest
+
+    reader.join();
+    writer.join();
+
+    stats.seconds = seconds_since(start);
+    return failed == false;
+}
+
+// Output file formats of `convert_rgba_file__*()`
+enum class image_format_t
+{
+    rgb, // Raw RGB, no header
+    ppm, // Netpbm binary PPM ("P6")
+    pam, // Netpbm PAM ("P7"), TUPLTYPE RGB
+};
+
+std::string make_image_header(image_format_t format, size_t width, size_t height)
+{
+    char header[256] = "";
+    switch(format)
+    {
+        case image_format_t::rgb:
+            break;
+        case image_format_t::ppm:
+            snprintf(header, sizeof(header), "P6\n%zu %zu\n255\n", width, height);
+            break;
+        case image_format_t::pam:
+            snprintf(header, sizeof(header), "P7\nWIDTH %zu\nHEIGHT %zu\nDEPTH 3\nMAXVAL 255\nTUPLTYPE RGB\nENDHDR\n", width, height);
+            break;
+    }
+    return header;
+}
+
+/*
+    Converts raw RGBA image file into RGB image file without copies through
+    user space buffers: input is mapped read-only, output file is allocated
+    (header + pixels) and mapped, kernel converts directly between mappings.
+    `MADV_SEQUENTIAL` makes kernel read ahead aggressively, and drop pages
+    behind. Input size must be exactly `width * height * 4` bytes.
+*/
+bool convert_rgba_file__mmap(const char* input_path, const char* output_path, size_t width, size_t height, image_format_t format)
+{
+    const size_t      num_pixels = width * height;
+    const std::string header     = make_image_header(format, width, height);
+    const size_t      input_size  = num_pixels * 4;
+    const size_t      output_size = header.size() + (num_pixels * 3);
+
+    const int input_fd = open(input_path, O_RDONLY);
+    if(input_fd < 0)
+    {
+        fprintf(stderr, "Failed to open '%s': %s\n", input_path, strerror(errno));
+        return false;
+    }
+
+    struct stat input_stat;
+    if((fstat(input_fd, &input_stat) != 0) || (static_cast<size_t>(input_stat.st_size) != input_size) || (input_size == 0))
+    {
+        fprintf(stderr, "Size of '%s' is not %zux%zu RGBA (%zu bytes)\n", input_path, width, height, input_size);
+        close(input_fd);
+        return false;
+    }
+
+    const int output_fd = open(output_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(output_fd < 0)
+    {
+        fprintf(stderr, "Failed to create '%s': %s\n", output_path, strerror(errno));
+        close(input_fd);
+        return false;
+    }
+
+    // Blocks of output are allocated upfront: with just `ftruncate()` the file is sparse, and
+    // filesystem allocates them one by one, on the first write fault of every page (~2x slower).
+    // Sparse file is only a fallback for filesystems without `fallocate()`: out of space, stores
+    // into the shared mapping would raise SIGBUS, so any other error fails here instead
+    int rc = posix_fallocate(output_fd, 0, static_cast<off_t>(output_size)); // Returns error, doesn't set `errno`
+    if(rc == EINVAL || rc == EOPNOTSUPP)
+    {
+        rc = (ftruncate(output_fd, static_cast<off_t>(output_size)) == 0) ? 0 : errno;
+    }
+    if(rc != 0)
+    {
+        fprintf(stderr, "Failed to allocate '%s' (%zu bytes): %s\n", output_path, output_size, strerror(rc));
+        close(input_fd);
+        close(output_fd);
+        return false;
+    }
+
+    void* const input  = mmap(nullptr, input_size,  PROT_READ,              MAP_SHARED, input_fd,  0);
+    void* const output = mmap(nullptr, output_size, PROT_READ | PROT_WRITE, MAP_SHARED, output_fd, 0);
+    close(input_fd);  // Mappings keep files open
+    close(output_fd);
+
+    if(input == MAP_FAILED || output == MAP_FAILED)
+    {
+        fprintf(stderr, "Failed to map '%s' or '%s': %s\n", input_path, output_path, strerror(errno));
+        if(input  != MAP_FAILED) { munmap(input,  input_size);  }
+        if(output != MAP_FAILED) { munmap(output, output_size); }
+        return false;
+    }
+
+    madvise(input,  input_size,  MADV_SEQUENTIAL);
+    madvise(output, output_size, MADV_SEQUENTIAL);
+
+    uint8_t* const rgb = static_cast<uint8_t*>(output);
+    memcpy(rgb, header.data(), header.size());
+    copy_rgba_to_rgb(static_cast<const uint8_t*>(input), rgb + header.size(), num_pixels);
+
+    // Write-back errors (e.g. I/O error) are only reported by `msync()`, not by `munmap()`
+    const bool ok = (msync(output, output_size, MS_SYNC) == 0);
+    if(ok == false)
+    {
+        fprintf(stderr, "Failed to write '%s': %s\n", output_path, strerror(errno));
+    }
+
+    munmap(input,  input_size);
+    munmap(output, output_size);
+    return ok;
+}
+
+/*
+    The same as `convert_rgba_file__mmap()`, with classic `read()` and
+    `write()` through chunk buffers (baseline for comparison).
+*/
+bool convert_rgba_file__read_write(const char* input_path, const char* output_path, size_t width, size_t height, image_format_t format)
+{
+    static constexpr size_t CHUNK_PIXELS = 256 * 1024; // 1 MiB of input
+
+    const size_t      num_pixels = width * height;
+    const std::string header     = make_image_header(format, width, height);
+
+    const int input_fd = open(input_path, O_RDONLY);
+    if(input_fd < 0)
+    {
+        fprintf(stderr, "Failed to open '%s': %s\n", input_path, strerror(errno));
+        return false;
+    }
+
+    const int output_fd = open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(output_fd < 0)
+    {
+        fprintf(stderr, "Failed to create '%s': %s\n", output_path, strerror(errno));
+        close(input_fd);
+        return false;
+    }
+
+    std::vector<uint8_t> rgba(CHUNK_PIXELS * 4);
+    std::vector<uint8_t> rgb (CHUNK_PIXELS * 3);
+
+    bool ok = write_fully(output_fd, reinterpret_cast<const uint8_t*>(header.data()), header.size());
+    for(size_t done = 0; ok && (done < num_pixels); done += CHUNK_PIXELS)
+    {
+        const size_t chunk_pixels = std::min(CHUNK_PIXELS, num_pixels - done);
+        if(read_fully(input_fd, rgba.data(), chunk_pixels * 4) != static_cast<ssize_t>(chunk_pixels * 4))
+        {
+            fprintf(stderr, "Size of '%s' is less than %zux%zu RGBA\n", input_path, width, height);
+            ok = false;
+            break;
+        }
+        copy_rgba_to_rgb(rgba.data(), rgb.data(), chunk_pixels);
+        ok = write_fully(output_fd, rgb.data(), chunk_pixels * 3);
+    }
+
+    close(input_fd);
+    ok = (close(output_fd) == 0) && ok;
+    return ok;
+}
+
+// -----------------------------------------------------------------------------
+// Command line
+
+#if defined(COPY_RGBA_TO_RGB__HAS_GIT_REVISION_H)
+    #include "git_revision.h" // Generated by CMake at build time
+#endif
+
+#if !defined(COPY_RGBA_TO_RGB__GIT_REVISION)
+    #define COPY_RGBA_TO_RGB__GIT_REVISION "unknown" // Built without CMake
+#endif
+
+#if !defined(COPY_RGBA_TO_RGB__BUILD_FLAGS)
+    #define COPY_RGBA_TO_RGB__BUILD_FLAGS "unknown" // Defined by CMake
+#endif
+
+struct image_size_t
+{
+    size_t width;
+    size_t height;
+};
+
+struct options_t
+{
+    bool                      validate   = true;  // `--bench-only`    disables
+    bool                      benchmark  = true;  // `--validate-only` disables
+    bool                      list       = false; // `--list`
+    bool                      help       = false; // `--help`
+    std::vector<std::string>  kernels;            // `--kernel=GLOB[,GLOB...]`, empty - all
+    std::vector<std::string>  suites;             // `--suite=NAME[,NAME...]`,  empty - all
+    std::vector<image_size_t> sizes{ {1920, 1080} }; // `--size=WxH[,WxH...]` or `--size=NUM_PIXELS`
+    bool                      sizes_given = false; // `--size` is given (tools require it, not the default)
+    size_t                    iterations = 0;     // `--iterations=N`, 0 - suite default
+    long                      warmup     = -1;    // `--warmup=N`,    -1 - suite default
+    std::string               json_path;          // `--json=FILE`
+    std::string               csv_path;           // `--csv=FILE`
+    std::string               save_baseline_path; // `--save-baseline=FILE`
+    std::string               compare_path;       // `--compare=FILE`
+    double                    threshold  = 5.0;   // `--threshold=PERCENT`, of median time
+    size_t                    fuzz_cases = 1000;  // `--fuzz-cases=N`, 0 - no guard-page fuzzing
+    long                      seed       = -1;    // `--seed=N`,      -1 - random
+    bool                      stream     = false; // `--stream`: stdin RGBA frames of `--size` --> stdout RGB
+    size_t                    buffers    = 4;     // `--buffers=N`, of each ring in `--stream`
+    std::string               convert_path;       // `--convert=FILE`: raw RGBA image of `--size` --> `--output`
+    std::string               output_path;        // `--output=FILE`
+    image_format_t            format     = image_format_t::ppm; // `--format=ppm|pam|rgb`
+    std::vector<std::string>  run_args;           // Arguments, which define what runs (stored into baseline)
+
+    bool runs_suite(const char* name) const
+    {
+        return suites.empty() || (std::find(suites.begin(), suites.end(), name) != suites.end());
+    }
+
+    bool selects_kernel(const char* name) const
+    {
+        if(kernels.empty())
+        {
+            return true;
+        }
+        for(const std::string& pattern : kernels)
+        {
+            if(fnmatch(pattern.c_str(), name, 0) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Suite's own `sizes`, followed by `--size` ones (without duplicates by number of pixels)
+    std::vector<image_size_t> sizes_with(std::vector<image_size_t> suite_sizes) const
+    {
+        for(const image_size_t& size : sizes)
+        {
+            const bool is_duplicate = std::any_of(suite_sizes.begin(), suite_sizes.end(), [&](const image_size_t& s) {
+                return (s.width * s.height) == (size.width * size.height);
+            });
+            if(is_duplicate == false)
+            {
+                suite_sizes.push_back(size);
+            }
+        }
+        return suite_sizes;
+    }
+};
+
+static const char* const BENCHMARK_SUITES[] =
+{
+    "main",        // Selected kernels, for each `--size`
+    "orders",      // All channel orders
+    "blend",       // Alpha compositing
+    "inplace",     // In-place compaction
+    "rgb_to_rgba", // RGB to RGBA
+    "small",       // Small sizes (1..512 pixels)
+    "sweep",       // Working set sweep (L1 .. DRAM)
+    "alignment",   // Source/destination alignment, 4K aliasing
+    "cold",        // Cold (flushed) vs warm caches, per frame
+    "hugepages",   // 4 KiB vs 2 MiB pages of frame buffers, dTLB misses
+    "fileio",      // File conversion: mmap vs read()/write()
+    "streaming",   // Regular vs streaming stores
+    "parallel",    // Multithreaded conversion
+    "batch",       // Many small images: per-image calls vs batch
+    "downscale",   // Fused 2x downscale vs two passes
+    "2d",          // 2D images with row padding
+    "flip",        // Bottom-up source: fused flip vs convert + flip
+    "yuv",         // RGBA to I420/NV12 vs RGB path
+    "planar",      // RGBA to planar uint8/float (ML tensor) vs RGB + split
+};
+
+void print_usage(const char* program)
+{
+    fprintf(stdout,
+        "Usage: %s [options]\n"
+        "\n"
+        "  --validate-only          Run validation only (exit code 1, if any case failed)\n"
+        "  --bench-only             Run benchmarks only\n"
+        "  --kernel=GLOB[,GLOB...]  Kernels (by name or glob, see --list) for suites: main, small, sweep, alignment\n"
+        "  --suite=NAME[,NAME...]   Benchmark suites to run (default - all):\n"
+        "                          ",
+        program);
+    for(const char* suite : BENCHMARK_SUITES)
+    {
+        fprintf(stdout, " %s", suite);
+    }
+    fprintf(stdout,
+        "\n"
+        "  --size=WxH[,WxH...]      Image sizes for 'main' suite (default - 1920x1080), or number of pixels\n"
+        "  --iterations=N           Minimal iterations per epoch (default - per suite)\n"
+        "  --warmup=N               Warmup iterations (default - per suite)\n"
+        "  --json=FILE              Write results (with build and host metadata) as JSON\n"
+        "  --csv=FILE               Write results (with build and host metadata) as CSV\n"
+        "  --save-baseline=FILE     Save epoch samples of all results, for later --compare\n"
+        "  --compare=FILE           Compare with saved baseline (Mann-Whitney U test), exit code 3 on regression.\n"
+        "                           Without selection options re-runs the baseline's suites, kernels and sizes\n"
+        "  --threshold=PERCENT      Median time increase, counted as regression (default - 5)\n"
+        "  --fuzz-cases=N           Random cases of guard-page fuzzing (default - 1000, 0 - disabled)\n"
+        "  --seed=N                 Seed of guard-page fuzzing (default - random, printed)\n"
+        "  --list                   List kernels, available on this CPU\n"
+        "\n"
+        "Tools (instead of validation and benchmarks):\n"
+        "  --stream --size=WxH      Convert raw RGBA frames from stdin into raw RGB frames to stdout,\n"
+        "                           with overlapped reading, conversion and writing. Statistics - to stderr\n"
+        "                           (tools require a single --size, there is no default)\n"
+        "  --buffers=N              Frames in each buffer ring of --stream (default - 4)\n"
+        "  --convert=FILE --size=WxH --output=FILE\n"
+        "                           Convert raw RGBA image file via memory mappings\n"
+        "  --format=ppm|pam|rgb     Output file format of --convert (default - ppm)\n"
+        "  --help                   Show this help\n"
+        "\n"
+        "Exit code: 0 - success, 1 - validation failed, 2 - invalid arguments or I/O error, 3 - regression\n");
+    fflush(stdout);
+}
+
+std::vector<std::string> split_list(const std::string& list, char separator = ',')
+{
+    std::vector<std::string> items;
+
+    size_t begin = 0;
+    while(begin <= list.size())
+    {
+        size_t end = list.find(separator, begin);
+        if(end == std::string::npos)
+        {
+            end = list.size();
+        }
+        if(end > begin)
+        {
+            items.push_back(list.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+
+    return items;
+}
+
+// Parses non-negative integer, returns false if `text` is not a number
+bool parse_size(const std::string& text, size_t& value)
+{
+    if(text.empty() || (text.find_first_not_of("0123456789") != std::string::npos))
+    {
+        return false;
+    }
+    value = static_cast<size_t>(strtoull(text.c_str(), nullptr, 10));
+    return true;
+}
+
+// Returns false (and prints the reason) on invalid arguments
+bool parse_options(const std::vector<std::string>& args, options_t& options)
+{
+    for(const std::string& arg : args)
+    {
+
+        const size_t eq = arg.find('=');
+        const std::string key   = arg.substr(0, eq);
+        const std::string value = (eq == std::string::npos) ? std::string() : arg.substr(eq + 1);
+
+        static const char* const RUN_KEYS[] = {"--validate-only", "--bench-only", "--kernel", "--suite", "--size", "--iterations", "--warmup"};
+        if(std::find(std::begin(RUN_KEYS), std::end(RUN_KEYS), key) != std::end(RUN_KEYS))
+        {
+            options.run_args.push_back(arg);
+        }
+
+        if(key == "--help" || key == "-h")
+        {
+            options.help = true;
+        }
+        else if(key == "--list")
+        {
+            options.list = true;
+        }
+        else if(key == "--validate-only")
+        {
+            options.validate  = true;
+            options.benchmark = false;
+        }
+        else if(key == "--bench-only")
+        {
+            options.validate  = false;
+            options.benchmark = true;
+        }
+        else if(key == "--kernel")
+        {
+            const std::vector<std::string> patterns = split_list(value);
+            options.kernels.insert(options.kernels.end(), patterns.begin(), patterns.end());
+        }
+        else if(key == "--suite")
+        {
+            for(const std::string& suite : split_list(value))
+            {
+                const bool known = std::find_if(std::begin(BENCHMARK_SUITES), std::end(BENCHMARK_SUITES),
+                    [&](const char* name) { return suite == name; }) != std::end(BENCHMARK_SUITES);
+                if(known == false)
+                {
+                    fprintf(stderr, "Unknown suite: '%s' (see --help)\n", suite.c_str());
+                    return false;
+                }
+                options.suites.push_back(suite);
+            }
+        }
+        else if(key == "--size")
+        {
+            options.sizes_given = true;
+            options.sizes.clear();
+            for(const std::string& item : split_list(value))
+            {
+                image_size_t size{0, 0};
+                bool ok = false;
+
+                const size_t x = item.find('x');
+                if(x == std::string::npos)
+                {
+                    // Number of pixels: single row
+                    ok = parse_size(item, size.width);
+                    size.height = 1;
+                }
+                else
+                {
+                    ok = parse_size(item.substr(0, x), size.width) && parse_size(item.substr(x + 1), size.height);
+                }
+
+                if(ok == false || (size.width * size.height) == 0)
+                {
+                    fprintf(stderr, "Invalid size: '%s' (expected WxH or number of pixels)\n", item.c_str());
+                    return false;
+                }
+                options.sizes.push_back(size);
+            }
+            if(options.sizes.empty())
+            {
+                fprintf(stderr, "Empty --size (see --help)\n");
+                return false;
+            }
+        }
+        else if(key == "--iterations")
+        {
+            if(parse_size(value, options.iterations) == false || options.iterations == 0)
+            {
+                fprintf(stderr, "Invalid iterations: '%s'\n", value.c_str());
+                return false;
+            }
+        }
+        else if(key == "--warmup")
+        {
+            size_t warmup = 0;
+            if(parse_size(value, warmup) == false)
+            {
+                fprintf(stderr, "Invalid warmup: '%s'\n", value.c_str());
+                return false;
+            }
+            options.warmup = static_cast<long>(warmup);
+        }
+        else if(key == "--json" && value.empty() == false)
+        {
+            options.json_path = value;
+        }
+        else if(key == "--csv" && value.empty() == false)
+        {
+            options.csv_path = value;
+        }
+        else if(key == "--save-baseline" && value.empty() == false)
+        {
+            options.save_baseline_path = value;
+        }
+        else if(key == "--compare" && value.empty() == false)
+        {
+            options.compare_path = value;
+        }
+        else if(key == "--threshold")
+        {
+            char* end = nullptr;
+            options.threshold = strtod(value.c_str(), &end);
+            if(value.empty() || (*end != '\0') || options.threshold < 0.0)
+            {
+                fprintf(stderr, "Invalid threshold: '%s'\n", value.c_str());
+                return false;
+            }
+        }
+        else if(key == "--stream")
+        {
+            options.stream = true;
+        }
+        else if(key == "--buffers")
+        {
+            if(parse_size(value, options.buffers) == false || options.buffers < 2)
+            {
+                fprintf(stderr, "Invalid buffers (at least 2): '%s'\n", value.c_str());
+                return false;
+            }
+        }
+        else if(key == "--convert" && value.empty() == false)
+        {
+            options.convert_path = value;
+        }
+        else if(key == "--output" && value.empty() == false)
+        {
+            options.output_path = value;
+        }
+        else if(key == "--format")
+        {
+            if     (value == "ppm") { options.format = image_format_t::ppm; }
+            else if(value == "pam") { options.format = image_format_t::pam; }
+            else if(value == "rgb") { options.format = image_format_t::rgb; }
+            else
+            {
+                fprintf(stderr, "Unknown format: '%s' (see --help)\n", value.c_str());
+                return false;
+            }
+        }
+        else if(key == "--fuzz-cases")
+        {
+            if(parse_size(value, options.fuzz_cases) == false)
+            {
+                fprintf(stderr, "Invalid fuzz cases: '%s'\n", value.c_str());
+                return false;
+            }
+        }
+        else if(key == "--seed")
+        {
+            size_t seed = 0;
+            if(parse_size(value, seed) == false || seed > 0xFFFFFFFFu)
+            {
+                fprintf(stderr, "Invalid seed: '%s'\n", value.c_str());
+                return false;
+            }
+            options.seed = static_cast<long>(seed);
+        }
+        else
+        {
+            fprintf(stderr, "Unknown or invalid argument: '%s' (see --help)\n", arg.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Kernels from `registry`, selected by `--kernel`
+std::vector<copy_rgba_to_rgb_impl_t> select_kernels(const std::vector<copy_rgba_to_rgb_impl_t>& registry, const options_t& options)
+{
+    std::vector<copy_rgba_to_rgb_impl_t> selected;
+    for(const copy_rgba_to_rgb_impl_t& impl : registry)
+    {
+        if(options.selects_kernel(impl.name))
+        {
+            selected.push_back(impl);
+        }
+    }
+    return selected;
+}
+
+// Common settings of the benchmark, `--warmup` and `--iterations` override suite defaults
+void configure_bench(ankerl::nanobench::Bench& b, const options_t& options, size_t default_warmup, size_t default_iterations = 0)
+{
+    b.warmup((options.warmup >= 0) ? static_cast<size_t>(options.warmup) : default_warmup); // iters
+    b.relative(true);
+    b.performanceCounters(true);
+
+    const size_t iterations = (options.iterations > 0) ? options.iterations : default_iterations;
+    if(iterations > 0)
+    {
+        b.minEpochIterations(iterations);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Results export (JSON, CSV) with metadata, to compare runs from different hosts
+
+// CPU model name (from `/proc/cpuinfo`), or "unknown"
+std::string detect_cpu_model()
+{
+    std::string model = "unknown";
+
+    FILE* fp = fopen("/proc/cpuinfo", "r");
+    if(fp != nullptr)
+    {
+        char line[512];
+        while(fgets(line, sizeof(line), fp) != nullptr)
+        {
+            if(strncmp(line, "model name", 10) == 0)
+            {
+                const char* colon = strchr(line, ':');
+                if(colon != nullptr)
+                {
+                    model = colon + 1;
+                    model.erase(0, model.find_first_not_of(" \t"));
+                    model.erase(model.find_last_not_of(" \t\r\n") + 1);
+                }
+                break;
+            }
+        }
+        fclose(fp);
+    }
+
+    return model;
+}
+
+struct run_metadata_t
+{
+    std::string cpu_model;
+    std::string host;
+    std::string compiler;
+    std::string build_flags;
+    std::string git_revision;
+    std::string dispatched;
+};
+
+run_metadata_t collect_run_metadata()
+{
+    run_metadata_t metadata;
+    metadata.cpu_model = detect_cpu_model();
+
+    char host[256] = {0};
+    metadata.host = (gethostname(host, sizeof(host) - 1) == 0) ? host : "unknown";
+
+    #if defined(__clang__)
+        metadata.compiler = "clang " __clang_version__;
+    #elif defined(__GNUC__)
+        metadata.compiler = "gcc " __VERSION__;
+    #else
+        metadata.compiler = "unknown";
+    #endif
+
+    metadata.build_flags  = COPY_RGBA_TO_RGB__BUILD_FLAGS;
+    metadata.git_revision = COPY_RGBA_TO_RGB__GIT_REVISION;
+    metadata.dispatched   = copy_rgba_to_rgb_impl_name();
+
+    return metadata;
+}
+
+// Makes `text` safe to put inside of double quotes (both JSON and CSV)
+std::string escape_quoted(const std::string& text)
+{
+    std::string escaped;
+    for(const char c : text)
+    {
+        if(c == '"' || c == '\\') { escaped += '\''; }
+        else if(static_cast<unsigned char>(c) < 0x20) { escaped += ' '; }
+        else { escaped += c; }
+    }
+    return escaped;
+}
+
+// Per-epoch samples of a single benchmark result (time per `run()` call, in seconds)
+struct benchmark_samples_t
+{
+    std::string         title;
+    std::string         name;
+    std::vector<double> elapsed;
+};
+
+/*
+    Collects results of all benchmarks of the run and writes them into
+    `--json` and/or `--csv` files, rendered by nanobench templates.
+
+    JSON: `{"metadata": {...}, "benchmarks": [<nanobench json() per Bench>]}`
+    CSV:  nanobench csv() columns + metadata columns, one row per result
+*/
+class results_exporter_t
+{
+public:
+    results_exporter_t(const options_t& options, const run_metadata_t& metadata)
+        : m_options(options)
+        , m_metadata(metadata)
+    {
+        // Metadata is the same for every row: put it into the template as is
+        m_csv_template =
+            "{{#result}}\"{{title}}\";\"{{name}}\";\"{{unit}}\";{{batch}};{{median(elapsed)}};{{medianAbsolutePercentError(elapsed)}};"
+            "{{median(instructions)}};{{median(cpucycles)}};{{median(branchinstructions)}};{{median(branchmisses)}};{{sumProduct(iterations, elapsed)}};"
+            "\"" + escape_quoted(metadata.cpu_model)    + "\";"
+            "\"" + escape_quoted(metadata.host)         + "\";"
+            "\"" + escape_quoted(metadata.compiler)     + "\";"
+            "\"" + escape_quoted(metadata.build_flags)  + "\";"
+            "\"" + escape_quoted(metadata.git_revision) + "\";"
+            "\"" + escape_quoted(metadata.dispatched)   + "\"\n"
+            "{{/result}}";
+    }
+
+    void add(const ankerl::nanobench::Bench& b)
+    {
+        if(b.results().empty())
+        {
+            return;
+        }
+
+        for(const ankerl::nanobench::Result& result : b.results())
+        {
+            benchmark_samples_t samples;
+            samples.title = result.config().mBenchmarkTitle;
+            samples.name  = result.config().mBenchmarkName;
+            for(size_t i = 0; i < result.size(); ++i)
+            {
+                samples.elapsed.push_back(result.get(i, ankerl::nanobench::Result::Measure::elapsed));
+            }
+            m_samples.push_back(samples);
+        }
+
+        if(m_options.json_path.empty() == false)
+        {
+            std::ostringstream out;
+            ankerl::nanobench::render(ankerl::nanobench::templates::json(), b, out);
+            m_json_benchmarks.push_back(out.str());
+        }
+
+        if(m_options.csv_path.empty() == false)
+        {
+            std::ostringstream out;
+            ankerl::nanobench::render(m_csv_template, b, out);
+            m_csv_rows += out.str();
+        }
+    }
+
+    /*
+        Samples measured without nanobench (e.g. with untimed work between
+        calls), one call per sample: the same fields as from nanobench, where
+        they exist, so that `--json`, `--csv` and `--compare` include them.
+    */
+    void add(const benchmark_samples_t& samples)
+    {
+        if(samples.elapsed.empty())
+        {
+            return;
+        }
+
+        m_samples.push_back(samples);
+
+        std::vector<double> sorted = samples.elapsed;
+        std::sort(sorted.begin(), sorted.end());
+        const double median = sorted[sorted.size() / 2];
+
+        std::vector<double> errors;
+        for(const double sample : samples.elapsed)
+        {
+            errors.push_back((median > 0.0) ? (std::fabs(sample - median) / median) : 0.0);
+        }
+        std::sort(errors.begin(), errors.end());
+        const double error = errors[errors.size() / 2];
+
+        double total = 0.0;
+        for(const double sample : samples.elapsed)
+        {
+            total += sample;
+        }
+
+        if(m_options.json_path.empty() == false)
+        {
+            std::ostringstream out;
+            out.precision(15);
+            out << "{\n"
+                << "    \"results\": [\n"
+                << "        {\n"
+                << "            \"title\": \"" << escape_quoted(samples.title) << "\",\n"
+                << "            \"name\": \""  << escape_quoted(samples.name)  << "\",\n"
+                << "            \"unit\": \"op\",\n"
+                << "            \"batch\": 1,\n"
+                << "            \"epochs\": " << samples.elapsed.size() << ",\n"
+                << "            \"epochIterations\": 1,\n"
+                << "            \"median(elapsed)\": " << median << ",\n"
+                << "            \"medianAbsolutePercentError(elapsed)\": " << error << ",\n"
+                << "            \"totalTime\": " << total << ",\n"
+                << "            \"measurements\": [\n";
+            for(size_t i = 0; i < samples.elapsed.size(); ++i)
+            {
+                out << "                {\n"
+                    << "                    \"iterations\": 1,\n"
+                    << "                    \"elapsed\": " << samples.elapsed[i] << "\n"
+                    << "                }" << ((i + 1 < samples.elapsed.size()) ? ",\n" : "\n");
+            }
+            out << "            ]\n"
+                << "        }\n"
+                << "    ]\n"
+                << "}";
+            m_json_benchmarks.push_back(out.str());
+        }
+
+        if(m_options.csv_path.empty() == false)
+        {
+            // No performance counters: empty fields
+            std::ostringstream out;
+            out.precision(15);
+            out << "\"" << escape_quoted(samples.title) << "\";\"" << escape_quoted(samples.name) << "\";\"op\";1;"
+                << median << ";" << error << ";;;;;" << total << ";"
+                << "\"" << escape_quoted(m_metadata.cpu_model)    << "\";"
+                << "\"" << escape_quoted(m_metadata.host)         << "\";"
+                << "\"" << escape_quoted(m_metadata.compiler)     << "\";"
+                << "\"" << escape_quoted(m_metadata.build_flags)  << "\";"
+                << "\"" << escape_quoted(m_metadata.git_revision) << "\";"
+                << "\"" << escape_quoted(m_metadata.dispatched)   << "\"\n";
+            m_csv_rows += out.str();
+        }
+    }
+
+    // Returns false, if any file can't be written
+    bool write() const
+    {
+        bool ok = true;
+
+        if(m_options.json_path.empty() == false)
+        {
+            std::ofstream out(m_options.json_path);
+            out << "{\n"
+                << "    \"metadata\": {\n"
+                << "        \"cpu\": \""          << escape_quoted(m_metadata.cpu_model)    << "\",\n"
+                << "        \"host\": \""         << escape_quoted(m_metadata.host)         << "\",\n"
+                << "        \"compiler\": \""     << escape_quoted(m_metadata.compiler)     << "\",\n"
+                << "        \"build_flags\": \""  << escape_quoted(m_metadata.build_flags)  << "\",\n"
+                << "        \"git_revision\": \"" << escape_quoted(m_metadata.git_revision) << "\",\n"
+                << "        \"dispatched\": \""   << escape_quoted(m_metadata.dispatched)   << "\"\n"
+                << "    },\n"
+                << "    \"benchmarks\": [\n";
+            for(size_t i = 0; i < m_json_benchmarks.size(); ++i)
+            {
+                out << m_json_benchmarks[i] << ((i + 1 < m_json_benchmarks.size()) ? ",\n" : "\n");
+            }
+            out << "    ]\n"
+                << "}\n";
+
+            ok = ok && out.good();
+        }
+
+        if(m_options.csv_path.empty() == false)
+        {
+            std::ofstream out(m_options.csv_path);
+            out << "\"title\";\"name\";\"unit\";\"batch\";\"elapsed\";\"error %\";"
+                   "\"instructions\";\"cycles\";\"branches\";\"branch misses\";\"total\";"
+                   "\"cpu\";\"host\";\"compiler\";\"build flags\";\"git revision\";\"dispatched\"\n"
+                << m_csv_rows;
+
+            ok = ok && out.good();
+        }
+
+        return ok;
+    }
+
+    const std::vector<benchmark_samples_t>& samples() const { return m_samples; }
+
+private:
+    const options_t&         m_options;
+    const run_metadata_t     m_metadata;
+    std::string              m_csv_template;
+    std::vector<std::string> m_json_benchmarks;
+    std::string              m_csv_rows;
+
+    std::vector<benchmark_samples_t> m_samples;
+};
+
+// -----------------------------------------------------------------------------
+// Baseline comparison (regression detection)
+
+/*
+    Baseline file - plain text, tab-separated, one record per line:
+
+        args    <arg> <arg> ...                (what runs, see `options_t::run_args`)
+        result  <title> <name> <sample> ...    (epoch samples, seconds per call)
+*/
+struct baseline_t
+{
+    std::vector<std::string>         args;
+    std::vector<benchmark_samples_t> results;
+};
+
+bool save_baseline(const std::string& path, const std::vector<std::string>& args, const std::vector<benchmark_samples_t>& results)
+{
+    FILE* fp = fopen(path.c_str(), "w");
+    if(fp == nullptr)
+    {
+        return false;
+    }
+
+    fprintf(fp, "args");
+    for(const std::string& arg : args)
+    {
+        fprintf(fp, "\t%s", arg.c_str());
+    }
+    fprintf(fp, "\n");
+
+    for(const benchmark_samples_t& result : results)
+    {
+        fprintf(fp, "result\t%s\t%s", result.title.c_str(), result.name.c_str());
+        for(const double sample : result.elapsed)
+        {
+            fprintf(fp, "\t%.17g", sample);
+        }
+        fprintf(fp, "\n");
+    }
+
+    const bool ok = (ferror(fp) == 0);
+    fclose(fp);
+    return ok;
+}
+
+bool load_baseline(const std::string& path, baseline_t& baseline)
+{
+    std::ifstream in(path);
+    if(in.is_open() == false)
+    {
+        return false;
+    }
+
+    std::string line;
+    while(std::getline(in, line))
+    {
+        const std::vector<std::string> fields = split_list(line, '\t');
+        if(fields.empty())
+        {
+            continue;
+        }
+
+        if(fields[0] == "args")
+        {
+            baseline.args.assign(fields.begin() + 1, fields.end());
+        }
+        else if(fields[0] == "result" && fields.size() >= 4)
+        {
+            benchmark_samples_t result;
+            result.title = fields[1];
+            result.name  = fields[2];
+            for(size_t i = 3; i < fields.size(); ++i)
+            {
+                result.elapsed.push_back(strtod(fields[i].c_str(), nullptr));
+            }
+            baseline.results.push_back(result);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+double median_of(std::vector<double> values)
+{
+    if(values.empty())
+    {
+        return 0.0;
+    }
+    const size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    return values[mid];
+}
+
+/*
+    Two-sided Mann-Whitney U test (normal approximation, with tie and
+    continuity corrections): probability, that samples `a` and `b` come from
+    the same distribution. Doesn't assume normality of epoch times (which
+    are skewed by interrupts, frequency changes, etc.)
+*/
+double mann_whitney_p_value(const std::vector<double>& a, const std::vector<double>& b)
+{
+    const size_t n1 = a.size();
+    const size_t n2 = b.size();
+    const size_t n  = n1 + n2;
+    if(n1 == 0 || n2 == 0)
+    {
+        return 1.0;
+    }
+
+    // (value, belongs to `a`)
+    std::vector< std::pair<double, bool> > all;
+    for(const double v : a) { all.push_back(std::make_pair(v, true));  }
+    for(const double v : b) { all.push_back(std::make_pair(v, false)); }
+    std::sort(all.begin(), all.end(), [](const std::pair<double, bool>& l, const std::pair<double, bool>& r) { return l.first < r.first; });
+
+    // Ranks (average for ties)
+    double rank_sum_a = 0.0;
+    double tie_term   = 0.0; // sum(t^3 - t) over groups of ties
+    for(size_t i = 0; i < n; )
+    {
+        size_t j = i;
+        while((j < n) && (all[j].first == all[i].first))
+        {
+            ++j;
+        }
+        const double rank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0; // Average of ranks i+1 .. j
+        for(size_t k = i; k < j; ++k)
+        {
+            if(all[k].second) { rank_sum_a += rank; }
+        }
+        const double t = static_cast<double>(j - i);
+        tie_term += (t * t * t) - t;
+        i = j;
+    }
+
+    const double dn1 = static_cast<double>(n1);
+    const double dn2 = static_cast<double>(n2);
+    const double dn  = static_cast<double>(n);
+
+    const double u     = rank_sum_a - (dn1 * (dn1 + 1.0) / 2.0);
+    const double mean  = dn1 * dn2 / 2.0;
+    const double sigma = std::sqrt((dn1 * dn2 / 12.0) * ((dn + 1.0) - (tie_term / (dn * (dn - 1.0)))));
+    if(sigma <= 0.0)
+    {
+        return 1.0;
+    }
+
+    const double z = std::max(0.0, std::fabs(u - mean) - 0.5) / sigma;
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+/*
+    Prints per-result deltas of median time against baseline, returns number
+    of regressions: slower by more than `threshold_percent` and statistically
+    significant (p < 0.05).
+*/
+size_t compare_with_baseline(const baseline_t& baseline, const std::vector<benchmark_samples_t>& current, double threshold_percent)
+{
+    static constexpr double SIGNIFICANCE = 0.05;
+
+    size_t num_regressions = 0;
+
+    fprintf(stdout, "\nComparison with baseline (threshold: %.1f %%, significance: p < %.2f)\n", threshold_percent, SIGNIFICANCE);
+    fprintf(stdout, "| %-40s | %-34s | %12s | %12s | %8s | %7s | %-10s |\n",
+            "title", "name", "base, ns", "now, ns", "delta", "p", "verdict");
+
+    for(const benchmark_samples_t& now : current)
+    {
+        const auto it = std::find_if(baseline.results.begin(), baseline.results.end(), [&](const benchmark_samples_t& base) {
+            return (base.title == now.title) && (base.name == now.name);
+        });
+        if(it == baseline.results.end())
+        {
+            fprintf(stdout, "| %-40s | %-34s | %12s | %12.1f | %8s | %7s | %-10s |\n",
+                    now.title.c_str(), now.name.c_str(), "-", median_of(now.elapsed) * 1e9, "-", "-", "new");
+            continue;
+        }
+
+        const double base_median = median_of(it->elapsed);
+        const double now_median  = median_of(now.elapsed);
+        const double delta       = (base_median > 0.0) ? (100.0 * (now_median / base_median - 1.0)) : 0.0; // > 0 - slower
+        const double p           = mann_whitney_p_value(it->elapsed, now.elapsed);
+
+        const char* verdict = "same";
+        if(p < SIGNIFICANCE && delta > threshold_percent)
+        {
+            verdict = "REGRESSED";
+            ++num_regressions;
+        }
+        else if(p < SIGNIFICANCE && delta < -threshold_percent)
+        {
+            verdict = "improved";
+        }
+
+        fprintf(stdout, "| %-40s | %-34s | %12.1f | %12.1f | %+7.1f%% | %7.4f | %-10s |\n",
+                now.title.c_str(), now.name.c_str(), base_median * 1e9, now_median * 1e9, delta, p, verdict);
+    }
+
+    fprintf(stdout, "Regressions: %zu\n", num_regressions);
+    fflush(stdout);
+
+    return num_regressions;
+}
+
+// -----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    options_t options;
+    if(parse_options(args, options) == false)
+    {
+        return 2;
+    }
+
+    // Baseline to compare with: without own selection options re-run the same, as in baseline
+    baseline_t baseline;
+    if(options.compare_path.empty() == false)
+    {
+        if(load_baseline(options.compare_path, baseline) == false)
+        {
+            fprintf(stderr, "Failed to load baseline: '%s'\n", options.compare_path.c_str());
+            return 2;
+        }
+
+        if(options.run_args.empty() && (baseline.args.empty() == false))
+        {
+            std::vector<std::string> baseline_args = baseline.args;
+            baseline_args.insert(baseline_args.end(), args.begin(), args.end());
+
+            options = options_t();
+            if(parse_options(baseline_args, options) == false)
+            {
+                return 2;
+            }
+        }
+    }
+
+    if(options.help)
+    {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    if(options.list)
+    {
+        for(const copy_rgba_to_rgb_impl_t& impl : make_copy_rgba_to_rgb_registry())
+        {
+            fprintf(stdout, "%s\n", impl.name);
+        }
+        return 0;
+    }
+
+    // Tools: wrong geometry would silently cut the data into wrong frames, so no default size
+    if((options.stream || (options.convert_path.empty() == false)) && ((options.sizes_given == false) || (options.sizes.size() != 1)))
+    {
+        fprintf(stderr, "%s requires a single --size=WxH (see --help)\n", options.stream ? "--stream" : "--convert");
+        return 2;
+    }
+
+    if(options.stream)
+    {
+        signal(SIGPIPE, SIG_IGN); // Closed downstream pipe: report write error, instead of being killed
+
+        const image_size_t& size = options.sizes.front();
+
+        stream_stats_t stats;
+        const bool ok = convert_rgba_stream(STDIN_FILENO, STDOUT_FILENO, size.width * size.height, options.buffers, stats);
+
+        const double fps = (stats.seconds > 0.0) ? (static_cast<double>(stats.num_frames) / stats.seconds) : 0.0;
+        fprintf(stderr, "stream: %zu frames %zux%zu in %.3f s: %.1f frames/s, %.1f MB/s in\n", stats.num_frames,
+                size.width, size.height, stats.seconds, fps, fps * static_cast<double>(size.width * size.height * 4) / 1e6);
+        fprintf(stderr, "stream: reader    busy %8.3f s, stalled %8.3f s (no free input buffer)\n", stats.reader_busy, stats.reader_stall);
+        fprintf(stderr, "stream: converter busy %8.3f s, stalled %8.3f s (no input frame) + %.3f s (no free output buffer)\n",
+                stats.converter_busy, stats.converter_stall_input, stats.converter_stall_output);
+        fprintf(stderr, "stream: writer    busy %8.3f s, stalled %8.3f s (no converted frame)\n", stats.writer_busy, stats.writer_stall);
+
+        return ok ? 0 : 2;
+    }
+
+    if(options.convert_path.empty() == false)
+    {
+        if(options.output_path.empty())
+        {
+            fprintf(stderr, "--convert requires --output (see --help)\n");
+            return 2;
+        }
+
+        const image_size_t& size = options.sizes.front();
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if(convert_rgba_file__mmap(options.convert_path.c_str(), options.output_path.c_str(), size.width, size.height, options.format) == false)
+        {
+            return 2;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        fprintf(stdout, "%s --> %s: %zux%zu, %.3f s, %.1f MB/s (input)\n", options.convert_path.c_str(), options.output_path.c_str(),
+                size.width, size.height, seconds, (seconds > 0.0) ? (static_cast<double>(size.width * size.height * 4) / seconds / 1e6) : 0.0);
+        return 0;
+    }
+
+    const run_metadata_t metadata = collect_run_metadata();
+    results_exporter_t exporter(options, metadata);
+
+    print_lscpu();
+
+    fprintf(stdout, "\nCPU: %s, compiler: %s, git revision: %s\n", metadata.cpu_model.c_str(), metadata.compiler.c_str(), metadata.git_revision.c_str());
+
+    fprintf(stdout, "\ncopy_rgba_to_rgb() dispatched to: %s\n", copy_rgba_to_rgb_impl_name());
+    fprintf(stdout, "copy_rgba_to_rgb() streaming stores threshold: %zu bytes\n\n", copy_rgba_to_rgb_streaming_threshold());
+    fflush(stdout);
+
+    size_t num_failed_total = 0; // Of all validations, defines the exit code
+
+    // Validation
+    if(options.validate)
+    {
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        std::vector<size_t> num_pixels_cases;
+        for(size_t i = 0; i <= 512; ++i)
+        {
+            num_pixels_cases.push_back(i);
+        }
+        num_pixels_cases.push_back(800 * 600);
+        num_pixels_cases.push_back(1920 * 1080);
+
+        size_t num_failed = 0;
+        for(size_t i = 0; i < num_pixels_cases.size(); ++i)
+        {
+            const size_t num_pixels = num_pixels_cases[i];
+            fprintf(stdout, "%zu. Validation case: %zu pixels\n", i, num_pixels);
+            fflush(stdout);
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                const char*                    name = impl.name;
+                const copy_rgba_to_rgb_func_t& func = impl.func;
+
+                const std::vector<uint8_t> rgba = make_ascending_data(num_pixels * 4);
+                std::vector<uint8_t> rgb(num_pixels * 3, 0);
+
+                func(rgba.data(), rgb.data(), num_pixels);
+
+                if( compare_rgba_to_rgb(rgba.data(), rgb.data(), num_pixels) == false )
+                {
+                    fprintf(stdout, "%s failed for %zu pixels\n", name, num_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+        };
+
+        fprintf(stdout, "validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: all channel orders
+    if(options.validate)
+    {
+        size_t num_failed = 0;
+        num_failed += validate_4ch_to_3ch<rgba_order_t, rgb_order_t>("rgba to rgb");
+        num_failed += validate_4ch_to_3ch<rgba_order_t, bgr_order_t>("rgba to bgr");
+        num_failed += validate_4ch_to_3ch<bgra_order_t, rgb_order_t>("bgra to rgb");
+        num_failed += validate_4ch_to_3ch<bgra_order_t, bgr_order_t>("bgra to bgr");
+        num_failed += validate_4ch_to_3ch<argb_order_t, rgb_order_t>("argb to rgb");
+        num_failed += validate_4ch_to_3ch<argb_order_t, bgr_order_t>("argb to bgr");
+        num_failed += validate_4ch_to_3ch<abgr_order_t, rgb_order_t>("abgr to rgb");
+        num_failed += validate_4ch_to_3ch<abgr_order_t, bgr_order_t>("abgr to bgr");
+
+        fprintf(stdout, "channel orders validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: alpha compositing (against scalar reference, must be exact)
+    if(options.validate)
+    {
+        using test_func_t = void (*) (const uint8_t*, uint8_t*, size_t, uint8_t, uint8_t, uint8_t);
+        using test_name_and_func_t = std::pair< const char*, test_func_t >;
+        std::vector< test_name_and_func_t > registry;
+
+        #if COPY_RGBA_TO_RGB__HAS_AVX2
+        if(get_cpu_features().avx2)
+        {
+            registry.push_back(test_name_and_func_t{"blend: avx2 (8 pixels)", blend_rgba_over_rgb__avx2__8pixels});
+        }
+        #endif
+
+        std::vector<size_t> num_pixels_cases;
+        for(size_t i = 0; i <= 512; ++i)
+        {
+            num_pixels_cases.push_back(i);
+        }
+        num_pixels_cases.push_back(256 * 256); // All (alpha, value) pairs, see below
+
+        static constexpr uint8_t BG_R = 0x12, BG_G = 0x80, BG_B = 0xFF;
+
+        size_t num_failed = 0;
+        for(const size_t num_pixels : num_pixels_cases)
+        {
+            // Pixel `i` has alpha `i / 256` and R,G,B values around `i % 256`
+            std::vector<uint8_t> rgba(num_pixels * 4);
+            for(size_t i = 0; i < num_pixels; ++i)
+            {
+                rgba[(i * 4)    ] = static_cast<uint8_t>(i);
+                rgba[(i * 4) + 1] = static_cast<uint8_t>(i + 85);
+                rgba[(i * 4) + 2] = static_cast<uint8_t>(i + 170);
+                rgba[(i * 4) + 3] = static_cast<uint8_t>(i / 256);
+            }
+
+            std::vector<uint8_t> expected(num_pixels * 3, 0);
+            blend_rgba_over_rgb__raw_ptr(rgba.data(), expected.data(), num_pixels, BG_R, BG_G, BG_B);
+
+            for(const test_name_and_func_t& t : registry)
+            {
+                std::vector<uint8_t> rgb(num_pixels * 3, 0);
+                t.second(rgba.data(), rgb.data(), num_pixels, BG_R, BG_G, BG_B);
+
+                if(rgb != expected)
+                {
+                    fprintf(stdout, "%s failed for %zu pixels\n", t.first, num_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+        }
+
+        fprintf(stdout, "blend validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: in-place compaction
+    if(options.validate)
+    {
+        using test_func_t = void (*) (uint8_t*, size_t);
+        using test_name_and_func_t = std::pair< const char*, test_func_t >;
+        std::vector< test_name_and_func_t > registry
+        {
+              test_name_and_func_t{"inplace: raw_pointers (1 pixel)", rgba_to_rgb_inplace__raw_ptr}
+            , test_name_and_func_t{"inplace: dispatched",             rgba_to_rgb_inplace}
+        };
+
+        #if COPY_RGBA_TO_RGB__HAS_AVX2
+        if(get_cpu_features().avx2)
+        {
+            registry.push_back(test_name_and_func_t{"inplace: avx2 (32 pixels)", rgba_to_rgb_inplace__avx2__32pixels});
+        }
+        #endif
+
+        std::vector<size_t> num_pixels_cases;
+        for(size_t i = 0; i <= 512; ++i)
+        {
+            num_pixels_cases.push_back(i);
+        }
+        num_pixels_cases.push_back(1920 * 1080);
+
+        size_t num_failed = 0;
+        for(const size_t num_pixels : num_pixels_cases)
+        {
+            const std::vector<uint8_t> rgba = make_ascending_data(num_pixels * 4);
+
+            for(const test_name_and_func_t& t : registry)
+            {
+                std::vector<uint8_t> buf = rgba;
+                t.second(buf.data(), num_pixels);
+
+                if( compare_rgba_to_rgb(rgba.data(), buf.data(), num_pixels) == false )
+                {
+                    fprintf(stdout, "%s failed for %zu pixels\n", t.first, num_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+        }
+
+        fprintf(stdout, "inplace validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: RGB to RGBA
+    if(options.validate)
+    {
+        using test_func_t = void (*) (const uint8_t*, uint8_t*, size_t, uint8_t);
+        using test_name_and_func_t = std::pair< const char*, test_func_t >;
+        std::vector< test_name_and_func_t > registry
+        {
+            test_name_and_func_t{"rgb to rgba: raw_pointers (1 pixel)", copy_rgb_to_rgba__raw_ptr}
+        };
+
+        #if COPY_RGBA_TO_RGB__HAS_AVX2
+        if(get_cpu_features().avx2)
+        {
+            registry.push_back(test_name_and_func_t{"rgb to rgba: avx2 (8 pixels)",  copy_rgb_to_rgba__avx2__8pixels});
+            registry.push_back(test_name_and_func_t{"rgb to rgba: avx2 (32 pixels)", copy_rgb_to_rgba__avx2__32pixels});
+        }
+        #endif
+
+        std::vector<size_t> num_pixels_cases;
         for(size_t i = 0; i <= 512; ++i)
         {
-            num_pixels_cases.push_back(i);
+            num_pixels_cases.push_back(i);
+        }
+        num_pixels_cases.push_back(800 * 600);
+        num_pixels_cases.push_back(1920 * 1080);
+
+        static constexpr uint8_t ALPHA = 0xA5;
+
+        size_t num_failed = 0;
+        for(const size_t num_pixels : num_pixels_cases)
+        {
+            for(const test_name_and_func_t& t : registry)
+            {
+                const char*        name = t.first;
+                const test_func_t& func = t.second;
+
+                const std::vector<uint8_t> rgb = make_ascending_data(num_pixels * 3);
+                std::vector<uint8_t> rgba(num_pixels * 4, 0);
+
+                func(rgb.data(), rgba.data(), num_pixels, ALPHA);
+
+                if( compare_rgb_to_rgba(rgb.data(), rgba.data(), num_pixels, ALPHA) == false )
+                {
+                    fprintf(stdout, "%s failed for %zu pixels\n", name, num_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+        }
+
+        fprintf(stdout, "rgb to rgba validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: 2D images with row padding
+    if(options.validate)
+    {
+        const std::vector<size_t> widths    { 0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100 };
+        const std::vector<size_t> heights   { 0, 1, 2, 3, 7 };
+        const std::vector<size_t> paddings  { 0, 1, 3, 4, 13, 64 }; // in bytes
+
+        size_t num_failed = 0;
+        for(const size_t width : widths)
+        for(const size_t height : heights)
+        for(const size_t src_padding : paddings)
+        for(const size_t dst_padding : paddings)
+        for(const bool dst_bottom_up : {false, true})
+        {
+            const size_t src_pitch = (width * 4) + src_padding;
+            const size_t dst_pitch = (width * 3) + dst_padding;
+
+            // Exact size: the row at the highest address has no padding after it,
+            // and `dst` ends flush with a guard page (over-writes crash)
+            const std::vector<uint8_t> rgba = make_ascending_data( (height > 0) ? ((height - 1) * src_pitch + (width * 4)) : 0 );
+            const size_t     rgb_size = (height > 0) ? ((height - 1) * dst_pitch + (width * 3)) : 0;
+            guarded_buffer_t rgb_buffer(rgb_size);
+            uint8_t* const   rgb = rgb_buffer.end() - rgb_size;
+
+            // Bottom-up: row 0 is the last one in memory
+            uint8_t* const  first_dst_row    = (dst_bottom_up && (height > 0)) ? (rgb + ((height - 1) * dst_pitch)) : rgb;
+            const ptrdiff_t signed_dst_pitch = dst_bottom_up ? -static_cast<ptrdiff_t>(dst_pitch) : static_cast<ptrdiff_t>(dst_pitch);
+
+            copy_rgba_to_rgb_2d(
+                rgba.data(),   static_cast<ptrdiff_t>(src_pitch),
+                first_dst_row, signed_dst_pitch,
+                width, height
+            );
+
+            for(size_t y = 0; y < height; ++y)
+            {
+                if( compare_rgba_to_rgb(rgba.data() + (y * src_pitch), first_dst_row + (static_cast<ptrdiff_t>(y) * signed_dst_pitch), width) == false )
+                {
+                    fprintf(stdout, "2d failed for %zux%zu, src pitch: %zu, dst pitch: %td (row %zu)\n", width, height, src_pitch, signed_dst_pitch, y);
+                    fflush(stdout);
+                    ++num_failed;
+                    break;
+                }
+            }
+        }
+
+        fprintf(stdout, "2d validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: vertical flip (bottom-up source)
+    if(options.validate)
+    {
+        std::vector<image_size_t> sizes;
+        for(const size_t width : { 0, 1, 7, 8, 9, 31, 32, 33, 100 })
+        {
+            for(const size_t height : { 0, 1, 2, 5 })
+            {
+                sizes.push_back(image_size_t{width, height});
+            }
+        }
+        sizes.push_back(image_size_t{1920, 1080});
+
+        size_t num_failed = 0;
+        for(const image_size_t& size : sizes)
+        for(const size_t padding : { 0, 5 })
+        {
+            const size_t src_pitch = (size.width * 4) + padding;
+            const size_t dst_pitch = (size.width * 3) + padding;
+
+            const std::vector<uint8_t> rgba = make_ascending_data(size.height * src_pitch);
+            std::vector<uint8_t> rgb(size.height * dst_pitch, 0);
+
+            copy_rgba_to_rgb_flip_vertical(rgba.data(), src_pitch, rgb.data(), dst_pitch, size.width, size.height);
+
+            for(size_t y = 0; y < size.height; ++y)
+            {
+                const size_t src_y = size.height - 1 - y;
+                if( compare_rgba_to_rgb(rgba.data() + (src_y * src_pitch), rgb.data() + (y * dst_pitch), size.width) == false )
+                {
+                    fprintf(stdout, "flip failed for %zux%zu, padding: %zu (row %zu)\n", size.width, size.height, padding, y);
+                    fflush(stdout);
+                    ++num_failed;
+                    break;
+                }
+            }
+        }
+
+        fprintf(stdout, "flip validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: batch conversion (images of random sizes, back to back in one buffer)
+    if(options.validate)
+    {
+        size_t num_failed = 0;
+
+        std::mt19937 rng(12345);
+        for(const size_t num_jobs : {0, 1, 2, 7, 100, 1000})
+        {
+            std::vector<size_t> sizes(num_jobs);
+            size_t total_pixels = 0;
+            for(size_t& size : sizes)
+            {
+                size = rng() % 600;
+                total_pixels += size;
+            }
+
+            std::vector<uint8_t> rgba(total_pixels * 4 + 1);
+            for(uint8_t& value : rgba)
+            {
+                value = static_cast<uint8_t>(rng());
+            }
+
+            std::vector<copy_rgba_to_rgb_job_t> jobs;
+            size_t offset = 0;
+            for(const size_t size : sizes)
+            {
+                jobs.push_back(copy_rgba_to_rgb_job_t{rgba.data() + (offset * 4), nullptr, size});
+                offset += size;
+            }
+
+            for(const bool parallel : {false, true})
+            {
+                std::vector<uint8_t> rgb(total_pixels * 3 + 1, 0);
+                for(size_t j = 0, offset_j = 0; j < num_jobs; offset_j += sizes[j], ++j)
+                {
+                    jobs[j].rgb = rgb.data() + (offset_j * 3);
+                }
+
+                if(parallel) { copy_rgba_to_rgb_batch_parallel(jobs.data(), jobs.size()); }
+                else         { copy_rgba_to_rgb_batch         (jobs.data(), jobs.size()); }
+
+                if( (compare_rgba_to_rgb(rgba.data(), rgb.data(), total_pixels) == false) || (rgb[total_pixels * 3] != 0) )
+                {
+                    fprintf(stdout, "batch%s failed for %zu images (%zu pixels)\n", parallel ? " (parallel)" : "", num_jobs, total_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+        }
+
+        fprintf(stdout, "batch validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: fused 2x downscale vs scalar and vs two-pass (convert, then downscale RGB)
+    if(options.validate)
+    {
+        size_t num_failed = 0;
+
+        std::vector<image_size_t> sizes;
+        for(size_t width = 0; width <= 40; ++width)
+        {
+            for(size_t height = 0; height <= 5; ++height)
+            {
+                sizes.push_back(image_size_t{width, height});
+            }
+        }
+        sizes.push_back(image_size_t{1921, 1081});
+
+        std::mt19937 rng(22);
+        for(const image_size_t& size : sizes)
+        {
+            for(const size_t dst_padding : {0, 5})
+            {
+                const size_t    out_width  = size.width  / 2;
+                const size_t    out_height = size.height / 2;
+                const ptrdiff_t src_pitch  = static_cast<ptrdiff_t>(size.width * 4 + 4);
+                const ptrdiff_t dst_pitch  = static_cast<ptrdiff_t>(out_width * 3 + dst_padding);
+
+                std::vector<uint8_t> rgba(static_cast<size_t>(src_pitch) * size.height);
+                for(uint8_t& value : rgba)
+                {
+                    value = static_cast<uint8_t>(rng());
+                }
+
+                // Two-pass reference (padding is left as is: 0xA5)
+                std::vector<uint8_t> rgb_full(size.width * 3 * size.height);
+                std::vector<uint8_t> expected(static_cast<size_t>(dst_pitch) * out_height, 0xA5);
+                copy_rgba_to_rgb_2d(rgba.data(), src_pitch, rgb_full.data(), static_cast<ptrdiff_t>(size.width * 3), size.width, size.height);
+                downscale_2x_rgb__raw_ptr(rgb_full.data(), static_cast<ptrdiff_t>(size.width * 3), expected.data(), dst_pitch, size.width, size.height);
+
+                const std::vector< std::pair<const char*, copy_rgba_to_rgb_downscale_2x_func_t> > impls
+                {
+                    {"raw_pointers", copy_rgba_to_rgb_downscale_2x__raw_ptr},
+                    {"dispatched",   copy_rgba_to_rgb_downscale_2x},
+                };
+                for(const auto& impl : impls)
+                {
+                    std::vector<uint8_t> rgb(expected.size(), 0xA5);
+                    impl.second(rgba.data(), src_pitch, rgb.data(), dst_pitch, size.width, size.height);
+
+                    if(rgb != expected)
+                    {
+                        fprintf(stdout, "downscale 2x (%s) failed for %zux%zu, dst padding: %zu\n", impl.first, size.width, size.height, dst_padding);
+                        fflush(stdout);
+                        ++num_failed;
+                    }
+                }
+            }
+        }
+
+        fprintf(stdout, "downscale 2x validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: RGBA to I420/NV12 vs floating-point reference (+-1), all matrices and ranges
+    if(options.validate)
+    {
+        size_t num_failed = 0;
+
+        std::vector<image_size_t> sizes;
+        for(const size_t width : {0, 1, 2, 3, 15, 16, 17, 31, 32, 33, 34, 47, 100})
+        {
+            for(const size_t height : {0, 1, 2, 3, 4, 7})
+            {
+                sizes.push_back(image_size_t{width, height});
+            }
+        }
+        sizes.push_back(image_size_t{1921, 1081});
+
+        std::mt19937 rng(24);
+        for(const image_size_t& size : sizes)
+        {
+            const size_t    chroma_width  = (size.width  + 1) / 2;
+            const size_t    chroma_height = (size.height + 1) / 2;
+            const ptrdiff_t src_pitch     = static_cast<ptrdiff_t>(size.width * 4 + 4);
+            const ptrdiff_t y_pitch       = static_cast<ptrdiff_t>(size.width + 3);
+            const ptrdiff_t c_pitch       = static_cast<ptrdiff_t>(chroma_width * 2 + 5); // Enough for both U (or V) and UV
+
+            // Random pixels, and a few rows of extremes (black, white, primaries), where rounding errors peak
+            std::vector<uint8_t> rgba(static_cast<size_t>(src_pitch) * size.height);
+            for(uint8_t& value : rgba)
+            {
+                value = static_cast<uint8_t>(rng());
+            }
+            for(size_t y = 0; y < std::min<size_t>(size.height, 2); ++y)
+            {
+                for(size_t x = 0; x < size.width; ++x)
+                {
+                    static const uint8_t extremes[][3] = { {0, 0, 0}, {255, 255, 255}, {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 0}, {0, 255, 255}, {255, 0, 255} };
+                    memcpy(rgba.data() + (y * static_cast<size_t>(src_pitch)) + (x * 4), extremes[((x / 2) + (y * 3)) % 8], 3);
+                }
+            }
+
+            for(const yuv_matrix_t matrix : {yuv_matrix_t::bt601, yuv_matrix_t::bt709})
+            {
+                for(const yuv_range_t range : {yuv_range_t::limited, yuv_range_t::full})
+                {
+                    // Floating-point reference: chroma of a 2x2 block is chroma of its average color
+                    const double kr       = (matrix == yuv_matrix_t::bt601) ? 0.299 : 0.2126;
+                    const double kb       = (matrix == yuv_matrix_t::bt601) ? 0.114 : 0.0722;
+                    const double y_scale  = (range == yuv_range_t::limited) ? (219.0 / 255.0) : 1.0;
+                    const double uv_scale = (range == yuv_range_t::limited) ? (224.0 / 255.0) : 1.0;
+                    const double y_offset = (range == yuv_range_t::limited) ? 16.0 : 0.0;
+
+                    const auto pixel = [&](size_t x, size_t y) { return rgba.data() + (y * static_cast<size_t>(src_pitch)) + (x * 4); };
+                    const auto luma  = [&](double r, double g, double b) { return kr * r + (1.0 - kr - kb) * g + kb * b; };
+
+                    std::vector<double> expected_y(size.width * size.height), expected_u(chroma_width * chroma_height), expected_v(expected_u.size());
+                    for(size_t y = 0; y < size.height; ++y)
+                    {
+                        for(size_t x = 0; x < size.width; ++x)
+                        {
+                            const uint8_t* p = pixel(x, y);
+                            expected_y[(y * size.width) + x] = y_offset + y_scale * luma(p[0], p[1], p[2]);
+                        }
+                    }
+                    for(size_t cy = 0; cy < chroma_height; ++cy)
+                    {
+                        for(size_t cx = 0; cx < chroma_width; ++cx)
+                        {
+                            double rgb[3] = {0.0, 0.0, 0.0};
+                            for(size_t i = 0; i < 4; ++i)
+                            {
+                                const uint8_t* p = pixel(std::min((cx * 2) + (i % 2), size.width - 1), std::min((cy * 2) + (i / 2), size.height - 1));
+                                for(size_t ch = 0; ch < 3; ++ch) { rgb[ch] += p[ch] / 4.0; }
+                            }
+                            const double l = luma(rgb[0], rgb[1], rgb[2]);
+                            expected_u[(cy * chroma_width) + cx] = 128.0 + uv_scale * (rgb[2] - l) / (2.0 * (1.0 - kb));
+                            expected_v[(cy * chroma_width) + cx] = 128.0 + uv_scale * (rgb[0] - l) / (2.0 * (1.0 - kr));
+                        }
+                    }
+
+                    const auto differs = [](uint8_t actual, double expected) { return std::fabs(actual - expected) > 1.0; };
+
+                    for(const char* impl : {"i420: raw_pointers", "i420: dispatched", "nv12: raw_pointers", "nv12: dispatched"})
+                    {
+                        const bool nv12       = (impl[0] == 'n');
+                        const bool dispatched = (strstr(impl, "dispatched") != nullptr);
+
+                        // Padding is filled with 0xA5, and must stay intact
+                        std::vector<uint8_t> y_plane(static_cast<size_t>(y_pitch) * size.height,   0xA5);
+                        std::vector<uint8_t> u_plane(static_cast<size_t>(c_pitch) * chroma_height, 0xA5);
+                        std::vector<uint8_t> v_plane(static_cast<size_t>(c_pitch) * chroma_height, 0xA5);
+
+                        const yuv420_planes_t planes{y_plane.data(), y_pitch, u_plane.data(), c_pitch, nv12 ? nullptr : v_plane.data(), nv12 ? 0 : c_pitch};
+                        if(nv12)
+                        {
+                            if(dispatched) { copy_rgba_to_nv12(rgba.data(), src_pitch, y_plane.data(), y_pitch, u_plane.data(), c_pitch, size.width, size.height, matrix, range); }
+                            else           { copy_rgba_to_yuv420__raw_ptr<true>(rgba.data(), src_pitch, planes, size.width, size.height, matrix, range); }
+                        }
+                        else
+                        {
+                            if(dispatched) { copy_rgba_to_i420(rgba.data(), src_pitch, y_plane.data(), y_pitch, u_plane.data(), c_pitch, v_plane.data(), c_pitch, size.width, size.height, matrix, range); }
+                            else           { copy_rgba_to_yuv420__raw_ptr<false>(rgba.data(), src_pitch, planes, size.width, size.height, matrix, range); }
+                        }
+
+                        bool failed = false;
+                        for(size_t y = 0; y < size.height; ++y)
+                        {
+                            for(size_t x = 0; x < static_cast<size_t>(y_pitch); ++x)
+                            {
+                                const uint8_t actual = y_plane[(y * static_cast<size_t>(y_pitch)) + x];
+                                failed |= (x < size.width) ? differs(actual, expected_y[(y * size.width) + x]) : (actual != 0xA5);
+                            }
+                        }
+                        for(size_t cy = 0; cy < chroma_height; ++cy)
+                        {
+                            for(size_t x = 0; x < static_cast<size_t>(c_pitch); ++x)
+                            {
+                                const size_t  row = cy * static_cast<size_t>(c_pitch);
+                                const size_t  cx  = nv12 ? (x / 2) : x;
+                                const uint8_t u   = u_plane[row + x];
+                                const uint8_t v   = v_plane[row + x];
+                                if(cx >= chroma_width)
+                                {
+                                    failed |= (u != 0xA5) || (v != 0xA5);
+                                }
+                                else if(nv12)
+                                {
+                                    failed |= differs(u, ((x % 2) == 0 ? expected_u : expected_v)[(cy * chroma_width) + cx]) || (v != 0xA5);
+                                }
+                                else
+                                {
+                                    failed |= differs(u, expected_u[(cy * chroma_width) + cx]) || differs(v, expected_v[(cy * chroma_width) + cx]);
+                                }
+                            }
+                        }
+
+                        if(failed)
+                        {
+                            fprintf(stdout, "rgba to yuv420 (%s, %s, %s range) failed for %zux%zu\n", impl,
+                                (matrix == yuv_matrix_t::bt601) ? "bt601" : "bt709", (range == yuv_range_t::limited) ? "limited" : "full",
+                                size.width, size.height);
+                            fflush(stdout);
+                            ++num_failed;
+                        }
+                    }
+                }
+            }
+        }
+
+        fprintf(stdout, "rgba to yuv420 validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: RGBA to planar uint8 and normalized float (CHW) vs reference loop
+    if(options.validate)
+    {
+        size_t num_failed = 0;
+
+        std::vector<size_t> sizes;
+        for(size_t n = 0; n <= 70; ++n)
+        {
+            sizes.push_back(n);
+        }
+        sizes.push_back(224 * 224);
+        sizes.push_back(1920 * 1080 + 3);
+
+        std::mt19937 rng(25);
+        for(const size_t num_pixels : sizes)
+        {
+            std::vector<uint8_t> rgba(num_pixels * 4);
+            for(uint8_t& value : rgba)
+            {
+                value = static_cast<uint8_t>(rng());
+            }
+
+            // One extra element of each output must stay intact
+            std::vector<uint8_t> expected_planar(num_pixels * 3 + 1, 0xA5);
+            std::vector<float>   expected_tensor(num_pixels * 3 + 1, -1000.0f);
+            for(size_t c = 0; c < 3; ++c)
+            {
+                for(size_t i = 0; i < num_pixels; ++i)
+                {
+                    const uint8_t value = rgba[(i * 4) + c];
+                    expected_planar[(c * num_pixels) + i] = value;
+                    expected_tensor[(c * num_pixels) + i] = (value - IMAGENET_NORMALIZATION.mean[c]) * IMAGENET_NORMALIZATION.scale[c];
+                }
+            }
+
+            const std::vector< std::pair<const char*, void (*)(const uint8_t*, uint8_t*, size_t)> > planar_impls
+            {
+                {"raw_pointers", copy_rgba_to_planar__raw_ptr},
+                {"dispatched",   copy_rgba_to_planar},
+            };
+            for(const auto& impl : planar_impls)
+            {
+                std::vector<uint8_t> planar(expected_planar.size(), 0xA5);
+                impl.second(rgba.data(), planar.data(), num_pixels);
+
+                if(planar != expected_planar)
+                {
+                    fprintf(stdout, "rgba to planar (%s) failed for %zu pixels\n", impl.first, num_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+
+            std::vector< std::pair<const char*, void (*)(const uint8_t*, float*, size_t, const channel_normalization_t&)> > float_impls
+            {
+                {"raw_pointers", copy_rgba_to_planar_float__raw_ptr},
+                {"dispatched",   copy_rgba_to_planar_float},
+            };
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2 && get_cpu_features().fma)
+            {
+                float_impls.push_back({"avx2_fma, single pass", copy_rgba_to_planar_float__avx2_fma__single_pass});
+                float_impls.push_back({"avx2_fma, chunked",     copy_rgba_to_planar_float__avx2_fma__chunked});
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+            for(const auto& impl : float_impls)
+            {
+                std::vector<float> tensor(expected_tensor.size(), -1000.0f);
+                impl.second(rgba.data(), tensor.data(), num_pixels, IMAGENET_NORMALIZATION);
+
+                // `(value - mean) * scale` vs `value * scale + bias` (and FMA): a few ulp
+                bool failed = (tensor.back() != expected_tensor.back());
+                for(size_t i = 0; i < num_pixels * 3; ++i)
+                {
+                    failed |= std::fabs(tensor[i] - expected_tensor[i]) > 1e-5f;
+                }
+
+                if(failed)
+                {
+                    fprintf(stdout, "rgba to planar float (%s) failed for %zu pixels\n", impl.first, num_pixels);
+                    fflush(stdout);
+                    ++num_failed;
+                }
+            }
+        }
+
+        fprintf(stdout, "rgba to planar validation done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Validation: guard-page fuzzing of bounds of all kernels (over-reads, over-writes, tails)
+    if(options.validate && options.fuzz_cases > 0)
+    {
+        const uint32_t seed = (options.seed >= 0) ? static_cast<uint32_t>(options.seed)
+                                                  : static_cast<uint32_t>(std::random_device{}());
+        fprintf(stdout, "guard-page fuzzing: %zu cases, seed %u (reproduce with --seed=%u)\n", options.fuzz_cases, seed, seed);
+        fflush(stdout);
+
+        const size_t num_failed = fuzz_kernels_with_guard_pages(options.fuzz_cases, seed);
+
+        fprintf(stdout, "guard-page fuzzing done, failed cases: %zu\n", num_failed);
+        fflush(stdout);
+        num_failed_total += num_failed;
+    }
+
+    // Benchmarking: selected kernels, for each image size
+    if(options.benchmark && options.runs_suite("main"))
+    {
+        static constexpr size_t NUM_ITERATIONS = 5000; // Default, see `--iterations`
+
+        fprintf(stdout, "\nIterations count: %zu\n", (options.iterations > 0) ? options.iterations : NUM_ITERATIONS);
+        fflush(stdout);
+
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        for(const image_size_t& size : options.sizes)
+        {
+            const size_t NUM_PIXELS = size.width * size.height;
+
+            std::vector<uint8_t> rgba(NUM_PIXELS * 4, 255); // Input  RGBA buffer
+            std::vector<uint8_t> rgb (NUM_PIXELS * 3,   0); // Output RGB  buffer
+
+            const std::string title = "RGBA to RGB, " + std::to_string(size.width) + "x" + std::to_string(size.height);
+
+            ankerl::nanobench::Bench b;
+            b.title(title);
+            configure_bench(b, options, 100, NUM_ITERATIONS);
+
+            // -----------------------------------------------------------------
+
+            // First one (`memcpy (1 pixel)`, unless filtered out) is the baseline for `relative` column
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                const copy_rgba_to_rgb_func_t func = impl.func;
+                b.run(impl.name, [&]() {
+                    func(rgba.data(), rgb.data(), NUM_PIXELS);
+                });
+            }
+
+            // -----------------------------------------------------------------
+
+            // Roofline: how close kernels are to the memory bandwidth
+            const size_t num_kernel_results = b.results().size();
+            const double achievable_gb_per_second = run_bandwidth_baselines(b, rgba.data(), rgb.data(), NUM_PIXELS);
+
+            fprintf(stdout, "\nAchievable bandwidth (best of read + write baselines): %.2f GB/s\n", achievable_gb_per_second);
+            for(size_t k = 0; k < num_kernel_results; ++k)
+            {
+                const ankerl::nanobench::Result& result = b.results()[k];
+                const double gb_per_second = median_gb_per_second(result, NUM_PIXELS * (4 + 3));
+                fprintf(stdout, "| %-34s | %8.2f GB/s | %6.1f %% |\n", result.config().mBenchmarkName.c_str(),
+                        gb_per_second, (achievable_gb_per_second > 0.0) ? (100.0 * gb_per_second / achievable_gb_per_second) : 0.0);
+            }
+            fflush(stdout);
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: all channel orders (expected to be the same speed)
+    if(options.benchmark && options.runs_suite("orders"))
+    {
+        static constexpr size_t WIDTH  = 1920;
+        static constexpr size_t HEIGHT = 1080;
+        static constexpr size_t NUM_PIXELS = WIDTH * HEIGHT;
+
+        std::vector<uint8_t> src(NUM_PIXELS * 4, 255); // Input  4-channel buffer
+        std::vector<uint8_t> dst(NUM_PIXELS * 3,   0); // Output 3-channel buffer
+
+        ankerl::nanobench::Bench b;
+        b.title("Channel orders (copy_4ch_to_3ch)");
+        configure_bench(b, options, 10);
+
+        run_4ch_to_3ch_benchmark<rgba_order_t, rgb_order_t>(b, "rgba to rgb", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<rgba_order_t, bgr_order_t>(b, "rgba to bgr", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<bgra_order_t, rgb_order_t>(b, "bgra to rgb", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<bgra_order_t, bgr_order_t>(b, "bgra to bgr", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<argb_order_t, rgb_order_t>(b, "argb to rgb", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<argb_order_t, bgr_order_t>(b, "argb to bgr", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<abgr_order_t, rgb_order_t>(b, "abgr to rgb", src.data(), dst.data(), NUM_PIXELS);
+        run_4ch_to_3ch_benchmark<abgr_order_t, bgr_order_t>(b, "abgr to bgr", src.data(), dst.data(), NUM_PIXELS);
+
+        exporter.add(b);
+    }
+
+    // Benchmarking: alpha compositing vs plain alpha dropping
+    if(options.benchmark && options.runs_suite("blend"))
+    {
+        static constexpr size_t WIDTH  = 1920;
+        static constexpr size_t HEIGHT = 1080;
+        static constexpr size_t NUM_PIXELS = WIDTH * HEIGHT;
+
+        std::vector<uint8_t> rgba = make_random_data(NUM_PIXELS * 4); // Input  RGBA buffer (random alpha)
+        std::vector<uint8_t> rgb (NUM_PIXELS * 3, 0);                 // Output RGB  buffer
+
+        ankerl::nanobench::Bench b;
+        b.title("RGBA over background to RGB");
+        configure_bench(b, options, 10);
+
+        b.run("drop alpha: raw_pointers (4 pixels)", [&]() {
+            copy_rgba_to_rgb__raw_ptr__4pixels(rgba.data(), rgb.data(), NUM_PIXELS);
+        });
+
+        b.run("blend: raw_pointers (1 pixel)", [&]() {
+            blend_rgba_over_rgb__raw_ptr(rgba.data(), rgb.data(), NUM_PIXELS, 0, 0, 0);
+        });
+
+        #if COPY_RGBA_TO_RGB__HAS_AVX2
+        if(get_cpu_features().avx2)
+        {
+            b.run("drop alpha: avx2 (8 pixels)", [&]() {
+                copy_rgba_to_rgb__avx2__8pixels(rgba.data(), rgb.data(), NUM_PIXELS);
+            });
+
+            b.run("drop alpha: avx2 (32 pixels)", [&]() {
+                copy_rgba_to_rgb__avx2__32pixels(rgba.data(), rgb.data(), NUM_PIXELS);
+            });
+
+            b.run("blend: avx2 (8 pixels)", [&]() {
+                blend_rgba_over_rgb__avx2__8pixels(rgba.data(), rgb.data(), NUM_PIXELS, 0, 0, 0);
+            });
+        }
+        #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+        exporter.add(b);
+    }
+
+    // Benchmarking: in-place compaction vs separate output buffer
+    if(options.benchmark && options.runs_suite("inplace"))
+    {
+        static constexpr size_t WIDTH  = 3840;
+        static constexpr size_t HEIGHT = 2160;
+        static constexpr size_t NUM_PIXELS = WIDTH * HEIGHT;
+
+        // Memory: resident set growth, while converting a single frame (it's
+        // the peak - all buffers are alive and touched at this point)
+        {
+            // RSS may also shrink meanwhile (pages of other buffers released): growth is clamped at 0
+            const auto rss_growth_since = [](size_t rss_before) {
+                const size_t rss_after = current_rss_bytes();
+                return (rss_after > rss_before) ? (rss_after - rss_before) : size_t(0);
+            };
+
+            bool   mapped          = true;
+            size_t rss_two_buffers = 0;
+            {
+                const size_t rss_before = current_rss_bytes();
+
+                mapped_buffer_t rgba(NUM_PIXELS * 4);
+                mapped_buffer_t rgb (NUM_PIXELS * 3);
+                if(!rgba.data() || !rgb.data())
+                {
+                    mapped = false;
+                }
+                else
+                {
+                    memset(rgba.data(), 255, rgba.size());
+                    copy_rgba_to_rgb(rgba.data(), rgb.data(), NUM_PIXELS);
+
+                    rss_two_buffers = rss_growth_since(rss_before);
+                }
+            }
+
+            size_t rss_inplace = 0;
+            if(mapped)
+            {
+                const size_t rss_before = current_rss_bytes();
+
+                mapped_buffer_t buf(NUM_PIXELS * 4);
+                if(!buf.data())
+                {
+                    mapped = false;
+                }
+                else
+                {
+                    memset(buf.data(), 255, buf.size());
+                    rgba_to_rgb_inplace(buf.data(), NUM_PIXELS);
+
+                    rss_inplace = rss_growth_since(rss_before);
+                }
+            }
+
+            if(mapped)
+            {
+                fprintf(stdout, "\nRSS growth, 3840x2160 frame: two buffers: %.1f MiB, in-place: %.1f MiB\n",
+                    static_cast<double>(rss_two_buffers) / (1024.0 * 1024.0),
+                    static_cast<double>(rss_inplace    ) / (1024.0 * 1024.0)
+                );
+            }
+            else
+            {
+                fprintf(stdout, "\ninplace: failed to map 3840x2160 frame buffers, RSS growth skipped\n");
+            }
+            fflush(stdout);
+        }
+
+        std::vector<uint8_t> rgba(NUM_PIXELS * 4, 255); // Input  RGBA buffer (also in-place buffer)
+        std::vector<uint8_t> rgb (NUM_PIXELS * 3,   0); // Output RGB  buffer
+
+        ankerl::nanobench::Bench b;
+        b.title("RGBA to RGB, in-place, 3840x2160");
+        configure_bench(b, options, 10);
+
+        b.run("two buffers (copy_rgba_to_rgb)", [&]() {
+            copy_rgba_to_rgb(rgba.data(), rgb.data(), NUM_PIXELS);
+        });
+
+        // NOTE: after the first run buffer contains garbage, but the work is the same
+        b.run("in-place (rgba_to_rgb_inplace)", [&]() {
+            rgba_to_rgb_inplace(rgba.data(), NUM_PIXELS);
+        });
+
+        exporter.add(b);
+    }
+
+    // Benchmarking: RGB to RGBA
+    if(options.benchmark && options.runs_suite("rgb_to_rgba"))
+    {
+        static constexpr size_t WIDTH  = 1920;
+        static constexpr size_t HEIGHT = 1080;
+        static constexpr size_t NUM_PIXELS = WIDTH * HEIGHT;
+        static constexpr uint8_t ALPHA = 255;
+
+        std::vector<uint8_t> rgb (NUM_PIXELS * 3, 255); // Input  RGB  buffer
+        std::vector<uint8_t> rgba(NUM_PIXELS * 4,   0); // Output RGBA buffer
+
+        ankerl::nanobench::Bench b;
+        b.title("RGB to RGBA");
+        configure_bench(b, options, 10);
+
+        b.run("raw_pointers (1 pixel)", [&]() {
+            copy_rgb_to_rgba__raw_ptr(rgb.data(), rgba.data(), NUM_PIXELS, ALPHA);
+        });
+
+        #if COPY_RGBA_TO_RGB__HAS_AVX2
+        if(get_cpu_features().avx2)
+        {
+            b.run("avx2 (8 pixels)", [&]() {
+                copy_rgb_to_rgba__avx2__8pixels(rgb.data(), rgba.data(), NUM_PIXELS, ALPHA);
+            });
+
+            b.run("avx2 (32 pixels)", [&]() {
+                copy_rgb_to_rgba__avx2__32pixels(rgb.data(), rgba.data(), NUM_PIXELS, ALPHA);
+            });
+        }
+        #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+        exporter.add(b);
+    }
+
+    // Benchmarking: small sizes (sprites, thumbnails, narrow rows), where the
+    // remainder (`num_pixels % block`) is a large share of work
+    if(options.benchmark && options.runs_suite("small"))
+    {
+        const std::vector<size_t> num_pixels_cases
+        {
+            1, 3, 7, 8, 15, 31, 63, 64, 100, 127, 200, 255, 256, 383, 511, 512
+        };
+
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        std::vector<uint8_t> rgba(num_pixels_cases.back() * 4, 255); // Input  RGBA buffer (large enough for any case)
+        std::vector<uint8_t> rgb (num_pixels_cases.back() * 3,   0); // Output RGB  buffer (large enough for any case)
+
+        for(const size_t num_pixels : num_pixels_cases)
+        {
+            const std::string title = "RGBA to RGB, " + std::to_string(num_pixels) + " pixels";
+
+            ankerl::nanobench::Bench b;
+            b.title(title);
+            b.unit("pixel"); // Report ns/pixel
+            b.batch(num_pixels);
+            configure_bench(b, options, 100);
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                const copy_rgba_to_rgb_func_t func = impl.func;
+                b.run(impl.name, [&]() {
+                    func(rgba.data(), rgb.data(), num_pixels);
+                });
+            }
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: working set sweep (from L1 to DRAM), to see where each
+    // kernel stops scaling. Working set - bytes read + written (7 per pixel)
+    if(options.benchmark && options.runs_suite("sweep"))
+    {
+        static constexpr size_t BYTES_PER_PIXEL = 4 + 3;
+        static constexpr size_t MIN_WORKING_SET = 4 * 1024;          //   4 KiB
+        static constexpr size_t MAX_WORKING_SET = 512 * 1024 * 1024; // 512 MiB
+
+        const cache_sizes_t caches = detect_cache_sizes();
+
+        // Half of each cache level (fits) and twice of it (does not fit), plus DRAM
+        std::vector<size_t> working_sets{MIN_WORKING_SET};
+        for(const size_t cache_size : {caches.l1d, caches.l2, caches.l3})
+        {
+            if(cache_size > 0)
+            {
+                working_sets.push_back(cache_size / 2);
+                working_sets.push_back(cache_size * 2);
+            }
+        }
+        working_sets.push_back(std::max<size_t>(detect_last_level_cache_size() * 8, 256 * 1024 * 1024));
+
+        for(size_t& working_set : working_sets)
+        {
+            working_set = std::min(std::max(working_set, MIN_WORKING_SET), MAX_WORKING_SET);
+        }
+        std::sort(working_sets.begin(), working_sets.end());
+        working_sets.erase(std::unique(working_sets.begin(), working_sets.end()), working_sets.end());
+
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        const size_t max_num_pixels = working_sets.back() / BYTES_PER_PIXEL;
+        std::vector<uint8_t> rgba(max_num_pixels * 4, 255); // Input  RGBA buffer (large enough for any case)
+        std::vector<uint8_t> rgb (max_num_pixels * 3,   0); // Output RGB  buffer (large enough for any case)
+
+        // [working set][kernel]
+        std::vector< std::vector<double> > gb_per_second        (working_sets.size(), std::vector<double>(registry.size(), 0.0));
+        std::vector< std::vector<double> > cycles_per_pixel     (working_sets.size(), std::vector<double>(registry.size(), 0.0));
+        std::vector< std::vector<double> > percent_of_achievable(working_sets.size(), std::vector<double>(registry.size(), 0.0));
+
+        for(size_t w = 0; w < working_sets.size(); ++w)
+        {
+            const size_t num_pixels = working_sets[w] / BYTES_PER_PIXEL;
+
+            const std::string title = "RGBA to RGB, working set " + format_bytes(num_pixels * BYTES_PER_PIXEL) +
+                                      " (" + std::to_string(num_pixels) + " pixels)";
+
+            ankerl::nanobench::Bench b;
+            b.title(title);
+            b.unit("pixel"); // Report ns/pixel (and cycles/pixel, if performance counters are available)
+            b.batch(num_pixels);
+            configure_bench(b, options, 3);
+
+            for(size_t k = 0; k < registry.size(); ++k)
+            {
+                const copy_rgba_to_rgb_func_t func = registry[k].func;
+                b.run(registry[k].name, [&]() {
+                    func(rgba.data(), rgb.data(), num_pixels);
+                });
+
+                // Measurements are per `run()` call (not divided by batch size)
+                const ankerl::nanobench::Result& result = b.results().back();
+                gb_per_second[w][k] = median_gb_per_second(result, num_pixels * BYTES_PER_PIXEL);
+                if(result.has(ankerl::nanobench::Result::Measure::cpucycles) && (num_pixels > 0))
+                {
+                    cycles_per_pixel[w][k] = result.median(ankerl::nanobench::Result::Measure::cpucycles) / static_cast<double>(num_pixels);
+                }
+            }
+
+            const double achievable_gb_per_second = run_bandwidth_baselines(b, rgba.data(), rgb.data(), num_pixels);
+            for(size_t k = 0; k < registry.size(); ++k)
+            {
+                if(achievable_gb_per_second > 0.0)
+                {
+                    percent_of_achievable[w][k] = 100.0 * gb_per_second[w][k] / achievable_gb_per_second;
+                }
+            }
+
+            exporter.add(b);
+        }
+
+        // Summary: one row per kernel, one column per working set
+        const auto print_summary = [&](const char* what, const std::vector< std::vector<double> >& values) {
+            fprintf(stdout, "\n%s, L1d: %s, L2: %s, L3: %s\n", what,
+                    format_bytes(caches.l1d).c_str(), format_bytes(caches.l2).c_str(), format_bytes(caches.l3).c_str());
+
+            fprintf(stdout, "| %-34s |", "kernel \\ working set");
+            for(const size_t working_set : working_sets)
+            {
+                fprintf(stdout, " %10s |", format_bytes(working_set).c_str());
+            }
+            fprintf(stdout, "\n");
+
+            for(size_t k = 0; k < registry.size(); ++k)
+            {
+                fprintf(stdout, "| %-34s |", registry[k].name);
+                for(size_t w = 0; w < working_sets.size(); ++w)
+                {
+                    if(values[w][k] > 0.0) { fprintf(stdout, " %10.2f |", values[w][k]); }
+                    else                   { fprintf(stdout, " %10s |", "-");            }
+                }
+                fprintf(stdout, "\n");
+            }
+            fflush(stdout);
+        };
+
+        print_summary("GB/s (read + written)", gb_per_second);
+        print_summary("cycles/pixel", cycles_per_pixel);
+        print_summary("% of achievable bandwidth (best of read + write baselines)", percent_of_achievable);
+    }
+
+    // Benchmarking: source/destination alignment sweep (cache-line splits) and
+    // distances near 4 KiB between source and destination (4K aliasing)
+    if(options.benchmark && options.runs_suite("alignment"))
+    {
+        static constexpr size_t OFFSET_STEP = COPY_RGBA_TO_RGB__ALIGNMENT_SWEEP__OFFSET_STEP;
+        static constexpr size_t MAX_OFFSET  = 64; // Exclusive: offsets are 0..63 bytes from a cache line (and page) start
+        static constexpr size_t NUM_PIXELS  = 1024; // 4 KiB in, 3 KiB out: stays in L1, where split penalties are visible
+        static constexpr size_t PAGE_SIZE   = 4096;
+
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        std::vector<size_t> offsets;
+        for(size_t offset = 0; offset < MAX_OFFSET; offset += OFFSET_STEP)
+        {
+            offsets.push_back(offset);
+        }
+
+        // Sweep of offsets (`src_buffer`, `dst_buffer`) and of 4K aliasing (`buffer`: input, then output)
+        mapped_buffer_t src_buffer(PAGE_SIZE * 4);
+        mapped_buffer_t dst_buffer(PAGE_SIZE * 4);
+        mapped_buffer_t buffer    (PAGE_SIZE * 4);
+        if(!src_buffer.data() || !dst_buffer.data() || !buffer.data())
+        {
+            fprintf(stdout, "\nalignment: failed to map buffers, skipped\n");
+        }
+        else
+        {
+            // Page-aligned, so offsets are exact. Destination starts at the middle of
+            // the page: src/dst distance stays far from multiples of 4 KiB (no 4K aliasing)
+            memset(src_buffer.data(), 255, src_buffer.size());
+            uint8_t* const dst_base = dst_buffer.data() + (PAGE_SIZE / 2);
+
+            static const char HEAT_LEVELS[] = " .:-=+*#%@"; // From < 10 % of the best (' ') to >= 90 % of the best ('@')
+
+            fprintf(stdout, "\nAlignment sweep, %zu pixels, GB/s (read + written), rows - source offset, columns - destination offset\n", NUM_PIXELS);
+            fprintf(stdout, "Heat levels (share of the kernel's best case): '%s' - from < 10 %% to >= 90 %%\n", HEAT_LEVELS);
+            fflush(stdout);
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                // [src offset][dst offset]
+                std::vector< std::vector<double> > gb_per_second(offsets.size(), std::vector<double>(offsets.size(), 0.0));
+
+                double best = 0.0, worst = 0.0;
+                size_t worst_src = 0, worst_dst = 0;
+                for(size_t s = 0; s < offsets.size(); ++s)
+                {
+                    for(size_t d = 0; d < offsets.size(); ++d)
+                    {
+                        const uint8_t* src = src_buffer.data() + offsets[s];
+                        uint8_t*       dst = dst_base          + offsets[d];
+
+                        const double seconds = measure_min_seconds_per_call([&]() { impl.func(src, dst, NUM_PIXELS); });
+                        const double value   = (seconds > 0.0) ? (static_cast<double>(NUM_PIXELS * (4 + 3)) / seconds / 1e9) : 0.0;
+
+                        gb_per_second[s][d] = value;
+                        best = std::max(best, value);
+                        if(((s == 0) && (d == 0)) || (value < worst))
+                        {
+                            worst     = value;
+                            worst_src = offsets[s];
+                            worst_dst = offsets[d];
+                        }
+                    }
+                }
+
+                fprintf(stdout, "\n%s: aligned (0, 0): %.2f GB/s, best: %.2f GB/s, worst: %.2f GB/s at (src +%zu, dst +%zu)\n",
+                        impl.name, gb_per_second[0][0], best, worst, worst_src, worst_dst);
+
+                // Header: destination offsets (tens and ones digits)
+                fprintf(stdout, "      ");
+                for(const size_t offset : offsets) { fputc(static_cast<int>('0' + (offset / 10)), stdout); }
+                fprintf(stdout, "\n      ");
+                for(const size_t offset : offsets) { fputc(static_cast<int>('0' + (offset % 10)), stdout); }
+                fprintf(stdout, "\n");
+
+                for(size_t s = 0; s < offsets.size(); ++s)
+                {
+                    fprintf(stdout, "  %2zu |", offsets[s]);
+                    for(size_t d = 0; d < offsets.size(); ++d)
+                    {
+                        const double share = (best > 0.0) ? (gb_per_second[s][d] / best) : 0.0;
+                        const size_t level = std::min<size_t>(static_cast<size_t>(share * 10.0), 9);
+                        fputc(HEAT_LEVELS[level], stdout);
+                    }
+                    fprintf(stdout, "|\n");
+                }
+                fflush(stdout);
+            }
+
+            // ---------------------------------------------------------------------
+
+            // Distances near 4 KiB (and 8 KiB): loads may falsely depend on
+            // earlier stores, whose addresses match in the lowest 12 bits
+            static constexpr size_t ALIASING_NUM_PIXELS = 512; // 2 KiB in: never overlaps the output
+            const std::vector<ptrdiff_t> deltas{-256, -64, -16, -4, 0, 4, 16, 64, 256, 2048}; // +2048 - reference (far from aliasing)
+
+            memset(buffer.data(), 255, buffer.size());
+            const uint8_t* src = buffer.data();
+
+            fprintf(stdout, "\n4K aliasing sweep, %zu pixels, GB/s (read + written), columns - dst - src distance\n", ALIASING_NUM_PIXELS);
+            fprintf(stdout, "| %-34s |", "kernel \\ distance");
+            for(const ptrdiff_t delta : deltas)
+            {
+                fprintf(stdout, " %7s%+5td |", "4 KiB", delta);
+            }
+            fprintf(stdout, "\n");
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                fprintf(stdout, "| %-34s |", impl.name);
+                for(const ptrdiff_t delta : deltas)
+                {
+                    uint8_t* dst = buffer.data() + (static_cast<ptrdiff_t>(PAGE_SIZE) + delta); // Always after the input
+
+                    const double seconds = measure_min_seconds_per_call([&]() { impl.func(src, dst, ALIASING_NUM_PIXELS); });
+                    fprintf(stdout, " %12.2f |", (seconds > 0.0) ? (static_cast<double>(ALIASING_NUM_PIXELS * (4 + 3)) / seconds / 1e9) : 0.0);
+                }
+                fprintf(stdout, "\n");
+                fflush(stdout);
+            }
+
+            // ---------------------------------------------------------------------
+
+            // Sweeps above are printed only. Exported (`--json`, `--csv`, `--compare`):
+            // fixed representative cases of each kernel, time per pixel
+            struct alignment_case_t
+            {
+                const char*    name;
+                const uint8_t* src;
+                uint8_t*       dst;
+                size_t         num_pixels;
+            };
+            const std::vector<alignment_case_t> cases
+            {
+                {"src +0,  dst +0 (aligned)",      src_buffer.data(),      dst_base,      NUM_PIXELS},
+                {"src +1,  dst +0",                src_buffer.data() +  1, dst_base,      NUM_PIXELS},
+                {"src +0,  dst +1",                src_buffer.data(),      dst_base +  1, NUM_PIXELS},
+                {"src +60, dst +61",               src_buffer.data() + 60, dst_base + 61, NUM_PIXELS},
+                {"dst - src: 4 KiB (aliasing)",    src, buffer.data() + PAGE_SIZE,                      ALIASING_NUM_PIXELS},
+                {"dst - src: 4 KiB + 2 KiB (far)", src, buffer.data() + PAGE_SIZE + (PAGE_SIZE / 2), ALIASING_NUM_PIXELS},
+            };
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                ankerl::nanobench::Bench b;
+                b.title(std::string("Alignment, ") + impl.name);
+                b.unit("pixel");
+                configure_bench(b, options, 100, 10000);
+                b.relative(false); // Cases differ in pixels (batch), time per pixel is comparable instead
+
+                for(const alignment_case_t& c : cases)
+                {
+                    b.batch(c.num_pixels);
+                    b.run(c.name, [&]() { impl.func(c.src, c.dst, c.num_pixels); });
+                }
+
+                exporter.add(b);
+            }
+        }
+    }
+
+    // Benchmarking: cold caches (frame arrives fresh from DMA or decoder) vs
+    // hot caches (the same frame converted again and again)
+    if(options.benchmark && options.runs_suite("cold"))
+    {
+        static constexpr size_t NUM_SAMPLES = 51; // Default, see `--iterations`
+
+        const size_t num_samples = (options.iterations > 0) ? options.iterations : NUM_SAMPLES;
+
+        // Small frames are the interesting ones: they fit into cache when warm
+        const std::vector<image_size_t> sizes = options.sizes_with({ {320, 240}, {640, 480} });
+
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        const char* evict_method = "scratch buffer";
+        #if COPY_RGBA_TO_RGB__X86
+        evict_method = get_cpu_features().clflushopt ? "clflushopt" : "clflush";
+        #endif
+
+        for(const image_size_t& size : sizes)
+        {
+            const size_t num_pixels = size.width * size.height;
+
+            mapped_buffer_t rgba(num_pixels * 4);
+            mapped_buffer_t rgb (num_pixels * 3);
+            if(!rgba.data() || !rgb.data())
+            {
+                fprintf(stdout, "\ncold: failed to map %zux%zu frame buffers, skipped\n", size.width, size.height);
+                continue;
+            }
+            memset(rgba.data(), 255, rgba.size());
+            memset(rgb.data(),  0,   rgb.size());
+
+            fprintf(stdout, "\nCold vs warm caches, %zux%zu (%s in, %s out), median of %zu calls, eviction: %s (not timed)\n",
+                    size.width, size.height, format_bytes(rgba.size()).c_str(), format_bytes(rgb.size()).c_str(), num_samples, evict_method);
+            fprintf(stdout, "| %-34s | %12s | %12s | %10s | %10s | %9s |\n",
+                    "kernel", "cold us", "warm us", "cold GB/s", "warm GB/s", "cold/warm");
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                const cold_warm_seconds_t seconds = measure_cold_and_warm_seconds_per_call(
+                    [&]() { impl.func(rgba.data(), rgb.data(), num_pixels); },
+                    [&]() { evict_from_caches(rgba.data(), rgba.size()); evict_from_caches(rgb.data(), rgb.size()); },
+                    num_samples);
+
+                const double bytes = static_cast<double>(num_pixels * (4 + 3));
+                fprintf(stdout, "| %-34s | %12.2f | %12.2f | %10.2f | %10.2f | %9.2f |\n",
+                        impl.name, seconds.cold * 1e6, seconds.warm * 1e6,
+                        (seconds.cold > 0.0) ? (bytes / seconds.cold / 1e9) : 0.0,
+                        (seconds.warm > 0.0) ? (bytes / seconds.warm / 1e9) : 0.0,
+                        (seconds.warm > 0.0) ? (seconds.cold / seconds.warm) : 0.0);
+                fflush(stdout);
+
+                // Eviction is not a part of samples, so they are exported as is, not through nanobench
+                const std::string title = "RGBA to RGB, " + std::to_string(size.width) + "x" + std::to_string(size.height) + ", cold vs warm caches";
+                exporter.add(benchmark_samples_t{title, std::string(impl.name) + " [cold]", seconds.cold_samples});
+                exporter.add(benchmark_samples_t{title, std::string(impl.name) + " [warm]", seconds.warm_samples});
+            }
+        }
+    }
+
+    // Benchmarking: 4 KiB vs 2 MiB pages of frame buffers (dTLB misses on large frames)
+    if(options.benchmark && options.runs_suite("hugepages"))
+    {
+        const std::vector<image_size_t> sizes = options.sizes_with({ {1920, 1080}, {3840, 2160}, {7680, 4320} });
+
+        const std::vector<copy_rgba_to_rgb_impl_t> registry = select_kernels(make_copy_rgba_to_rgb_registry(), options);
+
+        const dtlb_miss_counter_t dtlb_misses;
+
+        for(const image_size_t& size : sizes)
+        {
+            const size_t num_pixels = size.width * size.height;
+
+            mapped_buffer_t rgba_small(num_pixels * 4, false), rgb_small(num_pixels * 3, false);
+            mapped_buffer_t rgba_huge (num_pixels * 4, true),  rgb_huge (num_pixels * 3, true);
+            if(!rgba_small.data() || !rgb_small.data() || !rgba_huge.data() || !rgb_huge.data())
+            {
+                fprintf(stdout, "\nhugepages: failed to map %zux%zu frame buffers, skipped\n", size.width, size.height);
+                continue;
+            }
+
+            // Fault all pages in, before measurements
+            memset(rgba_small.data(), 255, rgba_small.size());
+            memset(rgba_huge.data(),  255, rgba_huge.size());
+            memset(rgb_small.data(),  0,   rgb_small.size());
+            memset(rgb_huge.data(),   0,   rgb_huge.size());
+
+            const char* const huge_name = (rgba_huge.pages() == page_kind_t::regular) ? "2 MiB (unavailable)" : "2 MiB";
+
+            fprintf(stdout, "\n%zux%zu frame buffers: %s pages", size.width, size.height, to_string(rgba_huge.pages()));
+            if(rgba_huge.pages() == page_kind_t::transparent_huge)
+            {
+                const size_t huge_bytes = transparent_huge_page_bytes(rgba_huge.data()) + transparent_huge_page_bytes(rgb_huge.data());
+                fprintf(stdout, ", %s of %s backed by huge pages", format_bytes(huge_bytes).c_str(), format_bytes(rgba_huge.mapping_size() + rgb_huge.mapping_size()).c_str());
+            }
+            fprintf(stdout, "\n");
+
+            ankerl::nanobench::Bench b;
+            b.title("RGBA to RGB, " + std::to_string(size.width) + "x" + std::to_string(size.height) + ", 4 KiB vs 2 MiB pages");
+            configure_bench(b, options, 1);
+
+            for(const copy_rgba_to_rgb_impl_t& impl : registry)
+            {
+                b.run(std::string(impl.name) + " [4 KiB]", [&]() { impl.func(rgba_small.data(), rgb_small.data(), num_pixels); });
+                b.run(std::string(impl.name) + " [" + huge_name + "]", [&]() { impl.func(rgba_huge.data(), rgb_huge.data(), num_pixels); });
+            }
+
+            exporter.add(b);
+
+            // Summary: frame times from results above, dTLB misses from a few separate calls
+            static constexpr size_t TLB_CALLS = 4;
+
+            fprintf(stdout, "\n| %-34s | %12s | %12s | %8s | %16s | %16s |\n",
+                    "kernel", "4 KiB ms", "2 MiB ms", "speedup", "dTLB miss 4 KiB", "dTLB miss 2 MiB");
+            for(size_t k = 0; k < registry.size(); ++k)
+            {
+                const copy_rgba_to_rgb_impl_t& impl = registry[k];
+
+                const double small_seconds = b.results()[2 * k + 0].median(ankerl::nanobench::Result::Measure::elapsed);
+                const double huge_seconds  = b.results()[2 * k + 1].median(ankerl::nanobench::Result::Measure::elapsed);
+
+                char small_misses[32] = "-", huge_misses[32] = "-";
+                if(dtlb_misses.valid())
+                {
+                    const uint64_t small_count = dtlb_misses.count([&]() {
+                        for(size_t call = 0; call < TLB_CALLS; ++call) { impl.func(rgba_small.data(), rgb_small.data(), num_pixels); }
+                    });
+                    const uint64_t huge_count = dtlb_misses.count([&]() {
+                        for(size_t call = 0; call < TLB_CALLS; ++call) { impl.func(rgba_huge.data(), rgb_huge.data(), num_pixels); }
+                    });
+                    snprintf(small_misses, sizeof(small_misses), "%llu", static_cast<unsigned long long>(small_count / TLB_CALLS));
+                    snprintf(huge_misses,  sizeof(huge_misses),  "%llu", static_cast<unsigned long long>(huge_count  / TLB_CALLS));
+                }
+
+                fprintf(stdout, "| %-34s | %12.3f | %12.3f | %7.2fx | %16s | %16s |\n",
+                        impl.name, small_seconds * 1e3, huge_seconds * 1e3,
+                        (huge_seconds > 0.0) ? (small_seconds / huge_seconds) : 0.0, small_misses, huge_misses);
+            }
+            if(dtlb_misses.valid() == false)
+            {
+                fprintf(stdout, "(dTLB misses: perf_event_open() is not permitted, see /proc/sys/kernel/perf_event_paranoid)\n");
+            }
+            fflush(stdout);
         }
-        num_pixels_cases.push_back(800 * 600);
-        num_pixels_cases.push_back(1920 * 1080);
+    }
 
-        for(size_t i = 0; i < num_pixels_cases.size(); ++i)
+    // Benchmarking: file conversion via memory mappings vs `read()`/`write()`
+    if(options.benchmark && options.runs_suite("fileio"))
+    {
+        const char* const tmp_dir = (getenv("TMPDIR") != nullptr) ? getenv("TMPDIR") : "/tmp";
+
+        const std::string input_path  = std::string(tmp_dir) + "/copy_rgba_to_rgb." + std::to_string(getpid()) + ".rgba";
+        const std::string output_path = std::string(tmp_dir) + "/copy_rgba_to_rgb." + std::to_string(getpid()) + ".ppm";
+
+        for(const image_size_t& size : options.sizes_with({ {7680, 4320} }))
         {
-            const size_t num_pixels = num_pixels_cases[i];
-            fprintf(stdout, "%zu. Validation case: %zu pixels\n", i, num_pixels);
+            const size_t num_pixels = size.width * size.height;
+
+            // Input file (stays in page cache: measured is conversion and page cache traffic, not the disk)
+            {
+                std::vector<uint8_t> rgba(num_pixels * 4, 255);
+                const int fd = open(input_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+                const bool ok = (fd >= 0) && write_fully(fd, rgba.data(), rgba.size());
+                if(fd >= 0) { close(fd); }
+                if(ok == false)
+                {
+                    fprintf(stdout, "\nfileio: failed to write '%s', skipped\n", input_path.c_str());
+                    continue;
+                }
+            }
+
+            ankerl::nanobench::Bench b;
+            b.title("RGBA file to PPM file, " + std::to_string(size.width) + "x" + std::to_string(size.height) +
+                    " (" + format_bytes(num_pixels * 4) + ")");
+            configure_bench(b, options, 1);
+
+            bool ok = true;
+            b.run("mmap (MADV_SEQUENTIAL)", [&]() {
+                ok = convert_rgba_file__mmap(input_path.c_str(), output_path.c_str(), size.width, size.height, image_format_t::ppm) && ok;
+            });
+            b.run("read() / write() (1 MiB chunks)", [&]() {
+                ok = convert_rgba_file__read_write(input_path.c_str(), output_path.c_str(), size.width, size.height, image_format_t::ppm) && ok;
+            });
+
+            exporter.add(b);
+
+            for(const ankerl::nanobench::Result& result : b.results())
+            {
+                fprintf(stdout, "%-34s %10.1f MB/s (input)\n", result.config().mBenchmarkName.c_str(),
+                        1e3 * median_gb_per_second(result, num_pixels * 4));
+            }
+            if(ok == false)
+            {
+                fprintf(stdout, "fileio: conversion failed\n");
+            }
             fflush(stdout);
+        }
 
-            for(const test_name_and_func_t& t : registry)
+        unlink(input_path.c_str());
+        unlink(output_path.c_str());
+    }
+
+    // Benchmarking: many small images (sprites, thumbnails), per-image calls vs batch
+    if(options.benchmark && options.runs_suite("batch"))
+    {
+        static constexpr size_t NUM_PIXELS = 256 * 1024; // Of all images: 1 MiB RGBA + 768 KiB RGB, stays in L2, so per-call overhead is visible
+
+        struct batch_case_t
+        {
+            std::string name;
+            size_t      min_side;
+            size_t      max_side;
+        };
+
+        const std::vector<batch_case_t> cases
+        {
+            {"16x16",              16,  16},
+            {"32x32",              32,  32},
+            {"64x64",              64,  64},
+            {"128x128",           128, 128},
+            {"16..128 (mixed)",    16, 128},
+        };
+
+        for(const batch_case_t& c : cases)
+        {
+            std::mt19937 rng(1);
+
+            std::vector<size_t> sizes;
+            size_t total_pixels = 0;
+            while(total_pixels < NUM_PIXELS)
             {
-                const char*        name = t.first;
-                const test_func_t& func = t.second;
+                const size_t side = c.min_side + (rng() % (c.max_side - c.min_side + 1));
+                sizes.push_back(side * side);
+                total_pixels += side * side;
+            }
+            const size_t num_images = sizes.size();
 
-                const std::vector<uint8_t> rgba = make_ascending_data(num_pixels * 4);
-                std::vector<uint8_t> rgb(num_pixels * 3, 0);
+            std::vector<uint8_t> rgba(total_pixels * 4, 255); // Input  RGBA atlas
+            std::vector<uint8_t> rgb (total_pixels * 3,   0); // Output RGB  atlas
 
-                func(rgba.data(), rgb.data(), num_pixels);
+            std::vector<copy_rgba_to_rgb_job_t> jobs;
+            for(size_t j = 0, offset = 0; j < num_images; offset += sizes[j], ++j)
+            {
+                jobs.push_back(copy_rgba_to_rgb_job_t{rgba.data() + (offset * 4), rgb.data() + (offset * 3), sizes[j]});
+            }
 
-                if( compare_rgba_to_rgb(rgba.data(), rgb.data(), num_pixels) == false )
+            ankerl::nanobench::Bench b;
+            b.title(std::to_string(num_images) + " images " + c.name + " (" + format_bytes(total_pixels * 4) + " RGBA)");
+            configure_bench(b, options, 10, 10);
+            b.batch(num_images);
+            b.unit("image"); // op/s --> images/s
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("per image: avx2 (64 pixels)", [&]() {
+                    for(const copy_rgba_to_rgb_job_t& job : jobs) { copy_rgba_to_rgb__avx2__64pixels(job.rgba, job.rgb, job.num_pixels); }
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            b.run("per image: copy_rgba_to_rgb", [&]() {
+                for(const copy_rgba_to_rgb_job_t& job : jobs) { copy_rgba_to_rgb(job.rgba, job.rgb, job.num_pixels); }
+            });
+
+            b.run("copy_rgba_to_rgb_batch", [&]() {
+                copy_rgba_to_rgb_batch(jobs.data(), jobs.size());
+            });
+
+            b.run("copy_rgba_to_rgb_batch_parallel (" + std::to_string(copy_rgba_to_rgb_parallel_num_threads()) + " threads)", [&]() {
+                copy_rgba_to_rgb_batch_parallel(jobs.data(), jobs.size());
+            });
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: fused 2x downscale vs two passes (convert, then downscale RGB)
+    if(options.benchmark && options.runs_suite("downscale"))
+    {
+        for(const image_size_t& size : options.sizes_with({ {1920, 1080}, {3840, 2160} }))
+        {
+            const size_t width  = size.width;
+            const size_t height = size.height;
+
+            std::vector<uint8_t> rgba    (width * height * 4, 255);             // Input  RGBA frame
+            std::vector<uint8_t> rgb_full(width * height * 3,   0);             // Intermediate of two-pass (preallocated)
+            std::vector<uint8_t> rgb_half((width / 2) * (height / 2) * 3, 0);   // Output RGB, half resolution
+
+            const ptrdiff_t src_pitch  = static_cast<ptrdiff_t>(width * 4);
+            const ptrdiff_t full_pitch = static_cast<ptrdiff_t>(width * 3);
+            const ptrdiff_t half_pitch = static_cast<ptrdiff_t>((width / 2) * 3);
+
+            ankerl::nanobench::Bench b;
+            b.title("RGBA " + std::to_string(width) + "x" + std::to_string(height) + " to RGB " +
+                    std::to_string(width / 2) + "x" + std::to_string(height / 2));
+            configure_bench(b, options, 10, 10);
+
+            b.run("two-pass: copy_rgba_to_rgb + downscale RGB", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb_full.data(), width * height);
+                downscale_2x_rgb__raw_ptr(rgb_full.data(), full_pitch, rgb_half.data(), half_pitch, width, height);
+            });
+
+            b.run("fused: raw_pointers", [&]() {
+                copy_rgba_to_rgb_downscale_2x__raw_ptr(rgba.data(), src_pitch, rgb_half.data(), half_pitch, width, height);
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("fused: avx2", [&]() {
+                    copy_rgba_to_rgb_downscale_2x__avx2(rgba.data(), src_pitch, rgb_half.data(), half_pitch, width, height);
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: bottom-up source, fused flip vs convert + row-reversal pass
+    if(options.benchmark && options.runs_suite("flip"))
+    {
+        for(const image_size_t& size : options.sizes_with({ {1920, 1080}, {3840, 2160} }))
+        {
+            const size_t width     = size.width;
+            const size_t height    = size.height;
+            const size_t src_pitch = width * 4;
+            const size_t dst_pitch = width * 3;
+
+            std::vector<uint8_t> rgba    (height * src_pitch, 255); // Input  RGBA frame (bottom-up)
+            std::vector<uint8_t> rgb_temp(height * dst_pitch,   0); // Intermediate of convert + flip (preallocated)
+            std::vector<uint8_t> rgb     (height * dst_pitch,   0); // Output RGB frame  (top-down)
+
+            ankerl::nanobench::Bench b;
+            b.title("RGBA to RGB, bottom-up to top-down, " + std::to_string(width) + "x" + std::to_string(height));
+            configure_bench(b, options, 10, 10);
+
+            b.run("no flip: copy_rgba_to_rgb (reference)", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb.data(), width * height);
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("avx2 (32 pixels) + row-reversal memcpy", [&]() {
+                    copy_rgba_to_rgb__avx2__32pixels(rgba.data(), rgb_temp.data(), width * height);
+                    for(size_t y = 0; y < height; ++y)
+                    {
+                        memcpy(rgb.data() + (y * dst_pitch), rgb_temp.data() + ((height - 1 - y) * dst_pitch), dst_pitch);
+                    }
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            b.run("copy_rgba_to_rgb_flip_vertical", [&]() {
+                copy_rgba_to_rgb_flip_vertical(rgba.data(), src_pitch, rgb.data(), dst_pitch, width, height);
+            });
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: RGBA to YUV 4:2:0 (encoder input) vs RGB conversion of the same frame
+    if(options.benchmark && options.runs_suite("yuv"))
+    {
+        for(const image_size_t& size : options.sizes_with({ {1920, 1080}, {3840, 2160} }))
+        {
+            const size_t width         = size.width;
+            const size_t height        = size.height;
+            const size_t chroma_width  = (width  + 1) / 2;
+            const size_t chroma_height = (height + 1) / 2;
+
+            std::vector<uint8_t> rgba(width * height * 4, 0); // Input RGBA frame
+            std::vector<uint8_t> rgb (width * height * 3, 0); // Output of the RGB path (reference)
+            std::vector<uint8_t> y   (width * height, 0);     // Output Y plane
+            std::vector<uint8_t> u   (chroma_width * chroma_height * 2, 0); // Output U plane (I420) or UV plane (NV12)
+            std::vector<uint8_t> v   (chroma_width * chroma_height, 0);     // Output V plane (I420)
+
+            std::mt19937 rng(24);
+            for(uint8_t& value : rgba)
+            {
+                value = static_cast<uint8_t>(rng());
+            }
+
+            const ptrdiff_t src_pitch = static_cast<ptrdiff_t>(width * 4);
+            const ptrdiff_t y_pitch   = static_cast<ptrdiff_t>(width);
+            const ptrdiff_t c_pitch   = static_cast<ptrdiff_t>(chroma_width);
+
+            const yuv_matrix_t matrix = yuv_matrix_t::bt709;
+            const yuv_range_t  range  = yuv_range_t::limited;
+
+            const yuv420_planes_t i420_planes{y.data(), y_pitch, u.data(), c_pitch,     v.data(), c_pitch};
+            const yuv420_planes_t nv12_planes{y.data(), y_pitch, u.data(), c_pitch * 2, nullptr,  0};
+
+            ankerl::nanobench::Bench b;
+            b.title("RGBA to YUV 4:2:0 (BT.709, limited range), " + std::to_string(width) + "x" + std::to_string(height));
+            configure_bench(b, options, 10, 10);
+
+            b.run("RGB path: copy_rgba_to_rgb (reference)", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb.data(), width * height);
+            });
+
+            b.run("i420: raw_pointers", [&]() {
+                copy_rgba_to_yuv420__raw_ptr<false>(rgba.data(), src_pitch, i420_planes, width, height, matrix, range);
+            });
+
+            b.run("nv12: raw_pointers", [&]() {
+                copy_rgba_to_yuv420__raw_ptr<true>(rgba.data(), src_pitch, nv12_planes, width, height, matrix, range);
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("i420: avx2", [&]() {
+                    copy_rgba_to_yuv420__avx2<false>(rgba.data(), src_pitch, i420_planes, width, height, matrix, range);
+                });
+
+                b.run("nv12: avx2", [&]() {
+                    copy_rgba_to_yuv420__avx2<true>(rgba.data(), src_pitch, nv12_planes, width, height, matrix, range);
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: RGBA to planar (ML tensor) vs RGB kernels + split loop
+    if(options.benchmark && options.runs_suite("planar"))
+    {
+        for(const image_size_t& size : options.sizes_with({ {224, 224}, {640, 640}, {1920, 1080} }))
+        {
+            const size_t num_pixels = size.width * size.height;
+
+            std::vector<uint8_t> rgba  (num_pixels * 4, 0); // Input  RGBA frame
+            std::vector<uint8_t> rgb   (num_pixels * 3, 0); // Intermediate RGB frame (preallocated)
+            std::vector<uint8_t> planar(num_pixels * 3, 0); // Output uint8 planes (and intermediate of three-pass)
+            std::vector<float>   tensor(num_pixels * 3, 0); // Output float CHW tensor
+
+            std::mt19937 rng(25);
+            for(uint8_t& value : rgba)
+            {
+                value = static_cast<uint8_t>(rng());
+            }
+
+            const channel_normalization_t& normalization = IMAGENET_NORMALIZATION;
+
+            // The "before" of fused kernels: split RGB into planes, and/or normalize
+            const auto split = [&]() {
+                for(size_t i = 0; i < num_pixels; ++i)
                 {
-                    fprintf(stdout, "%s failed for %zu pixels\n", name, num_pixels);
-                    fflush(stdout);
+                    planar[i]                    = rgb[(i * 3) + 0];
+                    planar[num_pixels + i]       = rgb[(i * 3) + 1];
+                    planar[(num_pixels * 2) + i] = rgb[(i * 3) + 2];
                 }
+            };
+            const auto split_normalize = [&]() {
+                for(size_t i = 0; i < num_pixels; ++i)
+                {
+                    for(size_t c = 0; c < 3; ++c)
+                    {
+                        tensor[(c * num_pixels) + i] = (rgb[(i * 3) + c] - normalization.mean[c]) * normalization.scale[c];
+                    }
+                }
+            };
+
+            ankerl::nanobench::Bench b;
+            b.title("RGBA to planar RGB (CHW), " + std::to_string(size.width) + "x" + std::to_string(size.height));
+            configure_bench(b, options, 10);
+
+            b.run("float: three-pass: copy_rgba_to_rgb + split + normalize", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb.data(), num_pixels);
+                split();
+                for(size_t c = 0; c < 3; ++c)
+                {
+                    for(size_t i = 0; i < num_pixels; ++i)
+                    {
+                        tensor[(c * num_pixels) + i] = (planar[(c * num_pixels) + i] - normalization.mean[c]) * normalization.scale[c];
+                    }
+                }
+            });
+
+            b.run("float: copy_rgba_to_rgb__raw_ptr + split/normalize loop", [&]() {
+                copy_rgba_to_rgb__raw_ptr(rgba.data(), rgb.data(), num_pixels);
+                split_normalize();
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("float: copy_rgba_to_rgb__avx2__32pixels + split/normalize loop", [&]() {
+                    copy_rgba_to_rgb__avx2__32pixels(rgba.data(), rgb.data(), num_pixels);
+                    split_normalize();
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            b.run("float: fused: raw_pointers", [&]() {
+                copy_rgba_to_planar_float__raw_ptr(rgba.data(), tensor.data(), num_pixels, normalization);
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2 && get_cpu_features().fma)
+            {
+                b.run("float: fused: avx2_fma, single pass", [&]() {
+                    copy_rgba_to_planar_float__avx2_fma__single_pass(rgba.data(), tensor.data(), num_pixels, normalization);
+                });
+
+                b.run("float: fused: avx2_fma, chunked", [&]() {
+                    copy_rgba_to_planar_float__avx2_fma__chunked(rgba.data(), tensor.data(), num_pixels, normalization);
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            b.run("uint8: copy_rgba_to_rgb + split loop", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb.data(), num_pixels);
+                split();
+            });
+
+            b.run("uint8: fused: raw_pointers", [&]() {
+                copy_rgba_to_planar__raw_ptr(rgba.data(), planar.data(), num_pixels);
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("uint8: fused: avx2", [&]() {
+                    copy_rgba_to_planar__avx2(rgba.data(), planar.data(), num_pixels);
+                });
             }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            exporter.add(b);
+        }
+    }
+
+    // Benchmarking: regular vs streaming stores, to find the crossover point
+    // (streaming is expected to win only when frame does not fit into cache)
+    if(options.benchmark && options.runs_suite("streaming"))
+    {
+        const std::vector<size_t> num_pixels_cases
+        {
+            64 * 64,     //  16 KiB RGBA
+            256 * 256,   // 256 KiB RGBA
+            512 * 512,   //   1 MiB RGBA
+            800 * 600,   // ~ 2 MiB RGBA
+            1280 * 720,  // ~ 4 MiB RGBA
+            1920 * 1080, // ~ 8 MiB RGBA
+            3840 * 2160  // ~32 MiB RGBA
         };
+
+        for(const size_t num_pixels : num_pixels_cases)
+        {
+            std::vector<uint8_t> rgba(num_pixels * 4, 255); // Input  RGBA buffer
+            std::vector<uint8_t> rgb (num_pixels * 3,   0); // Output RGB  buffer
+
+            const std::string title =
+                "RGBA to RGB, " + std::to_string(num_pixels) + " pixels (" +
+                std::to_string((num_pixels * (4 + 3)) / 1024) + " KiB in + out)";
+
+            ankerl::nanobench::Bench b;
+            b.title(title);
+            configure_bench(b, options, 10);
+
+            b.run("regular stores (copy_rgba_to_rgb)", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb.data(), num_pixels, store_mode_t::regular);
+            });
+
+            #if COPY_RGBA_TO_RGB__HAS_AVX2
+            if(get_cpu_features().avx2)
+            {
+                b.run("avx2 (32 pixels, 32-byte stores)", [&]() {
+                    copy_rgba_to_rgb__avx2__32pixels__full_stores(rgba.data(), rgb.data(), num_pixels);
+                });
+
+                b.run("avx2 (streaming stores)", [&]() {
+                    copy_rgba_to_rgb__avx2__stream(rgba.data(), rgb.data(), num_pixels);
+                });
+            }
+            #endif // COPY_RGBA_TO_RGB__HAS_AVX2
+
+            b.run("automatic (copy_rgba_to_rgb)", [&]() {
+                copy_rgba_to_rgb(rgba.data(), rgb.data(), num_pixels, store_mode_t::automatic);
+            });
+
+            exporter.add(b);
+        }
     }
 
-    // Benchmarking
-    if(1)
+    // Benchmarking: multithreaded conversion, to see where memory bandwidth saturates
+    if(options.benchmark && options.runs_suite("parallel"))
     {
-        static constexpr size_t WIDTH  = 1920;
-        static constexpr size_t HEIGHT = 1080;
+        static constexpr size_t WIDTH  = 3840;
+        static constexpr size_t HEIGHT = 2160;
         static constexpr size_t NUM_PIXELS = WIDTH * HEIGHT;
-        static constexpr size_t NUM_ITERATIONS = 5000;
-
-        fprintf(stdout, "\nIterations count: %zu\n", NUM_ITERATIONS);
-        fflush(stdout);
 
         std::vector<uint8_t> rgba(NUM_PIXELS * 4, 255); // Input  RGBA buffer
         std::vector<uint8_t> rgb (NUM_PIXELS * 3,   0); // Output RGB  buffer
 
+        const size_t max_num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+        std::vector<size_t> num_threads_cases;
+        for(size_t n = 1; n < max_num_threads; n *= 2)
+        {
+            num_threads_cases.push_back(n);
+        }
+        num_threads_cases.push_back(max_num_threads);
+
         ankerl::nanobench::Bench b;
-        b.title("RGBA to RGB");
-        b.warmup(100); // iters
-        b.relative(true);
-        b.performanceCounters(true);
-        b.minEpochIterations(NUM_ITERATIONS);
+        b.title("RGBA to RGB, parallel, 3840x2160");
+        b.unit("byte"); // Throughput in bytes (read + written) per second
+        b.batch(NUM_PIXELS * (4 + 3));
+        configure_bench(b, options, 10);
 
-        // ---------------------------------------------------------------------
+        for(const size_t num_threads : num_threads_cases)
+        {
+            copy_rgba_to_rgb_parallel_set_num_threads(num_threads);
+
+            const std::string name = "parallel (" + std::to_string(num_threads) + " threads)";
+            b.run(name, [&]() {
+                copy_rgba_to_rgb_parallel(rgba.data(), rgb.data(), NUM_PIXELS);
+            });
+        }
+
+        copy_rgba_to_rgb_parallel_set_num_threads(max_num_threads);
+
+        exporter.add(b);
+    }
+
+    // Benchmarking: 2D images with and without row padding
+    if(options.benchmark && options.runs_suite("2d"))
+    {
+        static constexpr size_t WIDTH  = 1920;
+        static constexpr size_t HEIGHT = 1080;
 
-        b.run("memcpy (1 pixel)", [&]() {
-            copy_rgba_to_rgb__memcpy(rgba.data(), rgb.data(), NUM_PIXELS);
+        static constexpr size_t SRC_PITCH_TIGHT  = WIDTH * 4;
+        static constexpr size_t DST_PITCH_TIGHT  = WIDTH * 3;
+        static constexpr size_t SRC_PITCH_PADDED = SRC_PITCH_TIGHT + 256; // For example - GPU readback pitch
+        static constexpr size_t DST_PITCH_PADDED = DST_PITCH_TIGHT + 64;  // For example - encoder alignment
+
+        std::vector<uint8_t> rgba(HEIGHT * SRC_PITCH_PADDED, 255); // Input  RGBA buffer (large enough for any pitch)
+        std::vector<uint8_t> rgb (HEIGHT * DST_PITCH_PADDED,   0); // Output RGB  buffer (large enough for any pitch)
+
+        ankerl::nanobench::Bench b;
+        b.title("RGBA to RGB, 2d, 1920x1080");
+        configure_bench(b, options, 10);
+
+        b.run("2d (contiguous)", [&]() {
+            copy_rgba_to_rgb_2d(rgba.data(), SRC_PITCH_TIGHT, rgb.data(), DST_PITCH_TIGHT, WIDTH, HEIGHT);
         });
 
-        b.run("raw_pointers (1 pixel)", [&]() {
-            copy_rgba_to_rgb__raw_ptr(rgba.data(), rgb.data(), NUM_PIXELS);
+        b.run("2d (padded src)", [&]() {
+            copy_rgba_to_rgb_2d(rgba.data(), SRC_PITCH_PADDED, rgb.data(), DST_PITCH_TIGHT, WIDTH, HEIGHT);
         });
 
-        b.run("raw_pointers (4 pixels)", [&]() {
-            copy_rgba_to_rgb__raw_ptr__4pixels(rgba.data(), rgb.data(), NUM_PIXELS);
+        b.run("2d (padded src and dst)", [&]() {
+            copy_rgba_to_rgb_2d(rgba.data(), SRC_PITCH_PADDED, rgb.data(), DST_PITCH_PADDED, WIDTH, HEIGHT);
         });
 
-        #if defined(__AVX2__)
-            b.run("avx2 (8 pixels)", [&]() {
-                copy_rgba_to_rgb__avx2__8pixels(rgba.data(), rgb.data(), NUM_PIXELS);
-            });
+        // What callers had to do before: one call per row
+        b.run("per-row copy_rgba_to_rgb() (padded src and dst)", [&]() {
+            for(size_t y = 0; y < HEIGHT; ++y)
+            {
+                copy_rgba_to_rgb(rgba.data() + (y * SRC_PITCH_PADDED), rgb.data() + (y * DST_PITCH_PADDED), WIDTH);
+            }
+        });
 
-            b.run("avx2 (16 pixels)", [&]() {
-                copy_rgba_to_rgb__avx2__16pixels(rgba.data(), rgb.data(), NUM_PIXELS);
-            });
+        exporter.add(b);
+    }
 
-            b.run("avx2 (32 pixels)", [&]() {
-                copy_rgba_to_rgb__avx2__32pixels(rgba.data(), rgb.data(), NUM_PIXELS);
-            });
+    // -------------------------------------------------------------------------
 
-            b.run("avx2 (64 pixels)", [&]() {
-                copy_rgba_to_rgb__avx2__64pixels(rgba.data(), rgb.data(), NUM_PIXELS);
-            });
-        #endif // defined(__AVX2__)
+    if(exporter.write() == false)
+    {
+        fprintf(stderr, "Failed to write results (--json/--csv)\n");
+        return 2;
+    }
+
+    if(options.save_baseline_path.empty() == false)
+    {
+        if(save_baseline(options.save_baseline_path, options.run_args, exporter.samples()) == false)
+        {
+            fprintf(stderr, "Failed to save baseline: '%s'\n", options.save_baseline_path.c_str());
+            return 2;
+        }
+    }
+
+    if(num_failed_total > 0)
+    {
+        return 1;
+    }
+
+    if(options.compare_path.empty() == false)
+    {
+        if(compare_with_baseline(baseline, exporter.samples(), options.threshold) > 0)
+        {
+            return 3;
+        }
     }
 
     return 0;